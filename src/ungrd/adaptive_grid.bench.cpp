@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include "adaptive_grid.hpp"
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "grid.bench.hpp"
+
+using namespace ungrd;
+
+// The cells of RandomCells spread out over a box of 128^3 cells, which fills
+// less than 2% of the box. The adaptive grid picks a dense grid for the other
+// inputs.
+#define SPARSE_EXTENT_RANGE                                                    \
+  { 128, 128 }
+
+#define SPARSE_ENTRY_RANGE                                                     \
+  { 32 * 32 * 32, 32 * 32 * 32 }
+
+// FirstUpdate
+
+BENCHMARK_TEMPLATE(BMT_Grid_FirstUpdate_DenseCells, s32_e32_adaptive_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, DENSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(BMT_Grid_FirstUpdate_RandomCells, s32_e32_adaptive_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+// NoChangeUpdate
+
+BENCHMARK_TEMPLATE(BMT_Grid_NoChangeUpdate_DenseCells, s32_e32_adaptive_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, DENSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_NoChangeUpdate_RandomCells, s32_e32_adaptive_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+// CountAllEntries
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_CountAllEntries_DenseCells, s32_e32_adaptive_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, DENSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_CountAllEntries_RandomCells, s32_e32_adaptive_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+// sparse RandomCells, for all three grids
+
+BENCHMARK_TEMPLATE(BMT_Grid_NoChangeUpdate_RandomCells, s32_e32_dense_grid<3>)
+    ->Ranges(
+        {SPARSE_EXTENT_RANGE, SPARSE_EXTENT_RANGE, SPARSE_EXTENT_RANGE,
+         SPARSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(BMT_Grid_NoChangeUpdate_RandomCells, s32_e32_compact_grid<3>)
+    ->Ranges(
+        {SPARSE_EXTENT_RANGE, SPARSE_EXTENT_RANGE, SPARSE_EXTENT_RANGE,
+         SPARSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_NoChangeUpdate_RandomCells, s32_e32_adaptive_grid<3>)
+    ->Ranges(
+        {SPARSE_EXTENT_RANGE, SPARSE_EXTENT_RANGE, SPARSE_EXTENT_RANGE,
+         SPARSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(BMT_Grid_CountAllEntries_RandomCells, s32_e32_dense_grid<3>)
+    ->Ranges(
+        {SPARSE_EXTENT_RANGE, SPARSE_EXTENT_RANGE, SPARSE_EXTENT_RANGE,
+         SPARSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_CountAllEntries_RandomCells, s32_e32_compact_grid<3>)
+    ->Ranges(
+        {SPARSE_EXTENT_RANGE, SPARSE_EXTENT_RANGE, SPARSE_EXTENT_RANGE,
+         SPARSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_CountAllEntries_RandomCells, s32_e32_adaptive_grid<3>)
+    ->Ranges(
+        {SPARSE_EXTENT_RANGE, SPARSE_EXTENT_RANGE, SPARSE_EXTENT_RANGE,
+         SPARSE_ENTRY_RANGE});
@@ -0,0 +1,363 @@
+#ifndef UNGRD_ADAPTIVE_GRID_HPP_42820F19062C48B89AF1B8C88566A394
+#define UNGRD_ADAPTIVE_GRID_HPP_42820F19062C48B89AF1B8C88566A394
+
+#include "cxx/assert.hpp"
+
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "grid_stats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ungrd {
+
+// Stores its cells either in a dense_grid or in a compact_grid and picks the
+// cheaper one on every update. A dense grid costs one slot per cell of its
+// bounding box, a compact grid costs compact_cell_cost slots per filled cell
+// for the map and its hashing. The grid switches once the other
+// representation is cheaper by more than the factor 1 + hysteresis, so inputs
+// close to the break-even occupancy do not flip-flop between both.
+//
+// update and tracked_update measure the bounding box of their input and
+// estimate its filled cells before building, so only the chosen grid is built.
+// differential_update only sees the changes and switches afterwards, by
+// rebuilding the other grid from the entries of the current one. The grid it
+// switched from is released.
+template <
+    typename PSpace, typename PEntry,
+    typename TAllocator = std::allocator<typename PEntry::entry>>
+class adaptive_grid {
+public:
+  using space_policy = PSpace;
+  using entry_policy = PEntry;
+  using allocator_type = TAllocator;
+
+  using dense_grid_type =
+      dense_grid<space_policy, entry_policy, allocator_type>;
+  using compact_grid_type =
+      compact_grid<space_policy, entry_policy, allocator_type>;
+
+private:
+  static constexpr std::size_t ndim = space_policy::ndim;
+  using position_type = typename space_policy::position;
+
+  using entry_type = typename entry_policy::entry;
+
+public:
+  bool is_dense() const { return dense_; }
+
+  // the number of times the grid switched its representation
+  size_t switch_count() const { return switch_count_; }
+
+  // The filled cells over the cells of the bounding box after the last update.
+  double occupancy() const { return occupancy_; }
+
+  size_t count_filled_cells() const {
+    return visit([](auto const &grid) { return grid.count_filled_cells(); });
+  }
+
+  std::pair<position_type, position_type> bounding_box() const {
+    return visit([](auto const &grid) { return grid.bounding_box(); });
+  }
+
+  grid_stats<position_type> stats() const {
+    return visit([](auto const &grid) { return grid.stats(); });
+  }
+
+public:
+  template <typename FCallback>
+  void foreach_entry_at_position(
+      position_type const &cpos, FCallback callback) const {
+    visit([&](auto const &grid) {
+      grid.foreach_entry_at_position(cpos, std::move(callback));
+    });
+  }
+
+  template <typename FCallback>
+  void foreach_entry_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    visit([&](auto const &grid) {
+      grid.foreach_entry_in_box(lo, hi, std::move(callback));
+    });
+  }
+
+  template <typename FCallback>
+  void foreach_cell_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    visit([&](auto const &grid) {
+      grid.foreach_cell_in_box(lo, hi, std::move(callback));
+    });
+  }
+
+  template <typename TReal, typename FCallback>
+  void foreach_cell_along_ray(
+      std::array<TReal, ndim> const &origin,
+      std::array<TReal, ndim> const &direction,
+      std::type_identity_t<TReal> const t_max, FCallback callback) const {
+    visit([&](auto const &grid) {
+      grid.foreach_cell_along_ray(
+          origin, direction, t_max, std::move(callback));
+    });
+  }
+
+  template <typename FCallback>
+  void foreach_position(FCallback callback) const {
+    visit(
+        [&](auto const &grid) { grid.foreach_position(std::move(callback)); });
+  }
+
+public:
+  template <typename TInput>
+  void update(TInput const &input) {
+    auto const update = [&input](auto &grid) { grid.update(input); };
+    if (input_prefers_other(input, [](auto const &element) -> auto const & {
+          return std::get<0>(element);
+        }))
+      switch_with(update);
+    else
+      visit(update);
+    update_occupancy();
+  }
+
+  template <typename TPositions>
+  void tracked_update(TPositions const &cposes)
+    requires std::is_void_v<typename entry_policy::payload>
+  {
+    auto const update = [&cposes](auto &grid) { grid.tracked_update(cposes); };
+    if (input_prefers_other(
+            cposes, [](auto const &cpos) -> auto const & { return cpos; }))
+      switch_with(update);
+    else
+      visit(update);
+    update_occupancy();
+  }
+
+  // Without the full input, switching collects the entries of the grid. With
+  // payloads the switch is left to the next update instead.
+  template <typename TFresh, typename TStale>
+  void differential_update(TFresh const &fresh, TStale const &stale) {
+    visit([&](auto &grid) { grid.differential_update(fresh, stale); });
+
+    if constexpr (std::is_void_v<typename entry_policy::payload>) {
+      update_occupancy();
+      if (prefers_other(
+              static_cast<double>(count_filled_cells()), volume_)) {
+        auto &elements = elements_;
+        elements.clear();
+        foreach_position([&](position_type const &cpos) {
+          foreach_entry_at_position(cpos, [&](entry_type const entry) {
+            elements.emplace_back(cpos, entry);
+          });
+        });
+        switch_with([&elements](auto &grid) { grid.update(elements); });
+      }
+    }
+  }
+
+private:
+  template <typename FVisitor>
+  decltype(auto) visit(FVisitor &&visitor) const {
+    return dense_ ? visitor(*dense_grid_) : visitor(*compact_grid_);
+  }
+
+  template <typename FVisitor>
+  decltype(auto) visit(FVisitor &&visitor) {
+    return dense_ ? visitor(*dense_grid_) : visitor(*compact_grid_);
+  }
+
+  // Compares the costs of both representations for a grid of volume cells of
+  // which filled_cells are filled.
+  bool prefers_other(double const filled_cells, double const volume) const {
+    auto const dense_cost = volume;
+    auto const compact_cost = compact_cell_cost_ * filled_cells;
+    auto const threshold = 1 + hysteresis_;
+    return dense_ ? dense_cost > threshold * compact_cost
+                  : compact_cost > threshold * dense_cost;
+  }
+
+  // Compares the costs for the cell positions position_of(element) of the
+  // elements of input. The volume is that of their bounding box, the number of
+  // distinct positions is estimated from the sketch_size smallest position
+  // hashes (a k minimum values sketch), which is exact for fewer positions.
+  template <typename TInput, typename FPosition>
+  bool input_prefers_other(TInput const &input, FPosition position_of) {
+    auto &sketch = sketch_;
+    sketch.clear();
+
+    position_type lo = space_policy::most_positive_position();
+    position_type hi = space_policy::most_negative_position();
+
+    for (auto const &element : input) {
+      position_type const &cpos = position_of(element);
+      for (size_t dim = 0; dim < ndim; ++dim) {
+        lo[dim] = std::min(lo[dim], cpos[dim]);
+        hi[dim] = std::max(hi[dim], cpos[dim]);
+      }
+
+      auto const hash = hash_position(cpos);
+      if (sketch.size() == sketch_size and hash >= sketch.back())
+        continue;
+
+      auto it = std::lower_bound(sketch.begin(), sketch.end(), hash);
+      if (it != sketch.end() and *it == hash)
+        continue;
+
+      sketch.insert(it, hash);
+      if (sketch.size() > sketch_size)
+        sketch.pop_back();
+    }
+
+    if (sketch.empty())
+      return prefers_other(0, 0);
+
+    auto const filled_cells =
+        sketch.size() < sketch_size
+            ? static_cast<double>(sketch.size())
+            : (sketch_size - 1) / (static_cast<double>(sketch.back()) /
+                                   0x1p64);
+    return prefers_other(filled_cells, box_volume(lo, hi));
+  }
+
+  // Updates occupancy() and the volume of the bounding box.
+  void update_occupancy() {
+    auto const filled_cells = static_cast<double>(count_filled_cells());
+    auto const [lo, hi] = bounding_box();
+    volume_ = filled_cells > 0 ? box_volume(lo, hi) : 0;
+    occupancy_ = volume_ > 0 ? filled_cells / volume_ : 1;
+  }
+
+  static double box_volume(position_type const &lo, position_type const &hi) {
+    double volume = 1;
+    for (size_t dim = 0; dim < ndim; ++dim)
+      volume *= static_cast<double>(hi[dim]) - lo[dim] + 1;
+    return volume;
+  }
+
+  // a well mixed 64-bit hash, the sketch relies on uniform hash values
+  static std::uint64_t hash_position(position_type const &cpos) {
+    std::uint64_t hash = 0;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      hash = (hash ^ static_cast<std::uint64_t>(cpos[dim])) *
+             0x9E37'79B9'7F4A'7C15;
+      hash ^= hash >> 32;
+    }
+    // the finalizer of splitmix64
+    hash = (hash ^ (hash >> 30)) * 0xBF58'476D'1CE4'E5B9;
+    hash = (hash ^ (hash >> 27)) * 0x94D0'49BB'1331'11EB;
+    return hash ^ (hash >> 31);
+  }
+
+  // Builds the other representation with update and releases the current one.
+  template <typename FUpdate>
+  void switch_with(FUpdate update) {
+    if (dense_) {
+      update(compact_grid_.emplace(allocator_));
+      dense_grid_.reset();
+    } else {
+      update(dense_grid_.emplace(allocator_));
+      compact_grid_.reset();
+    }
+    dense_ = not dense_;
+    ++switch_count_;
+  }
+
+public:
+  allocator_type get_allocator() const { return allocator_; }
+
+  // Drops all cells of the current representation and frees their memory.
+  void clear() { visit([](auto &grid) { grid.clear(); }); }
+
+public:
+  adaptive_grid() : adaptive_grid{4., .5} {}
+
+  explicit adaptive_grid(
+      double const compact_cell_cost, double const hysteresis,
+      allocator_type const &allocator = allocator_type{})
+      : allocator_{allocator}, compact_cell_cost_{compact_cell_cost},
+        hysteresis_{hysteresis}, dense_grid_{std::in_place, allocator} {
+    UNGRD_ASSERT(
+        compact cells must not cost less than dense cells,
+        compact_cell_cost >= 1);
+    UNGRD_ASSERT(hysteresis must not be negative, hysteresis >= 0);
+  }
+
+  explicit adaptive_grid(allocator_type const &allocator)
+      : adaptive_grid{4., .5, allocator} {}
+
+  adaptive_grid(adaptive_grid const &) = delete;
+  adaptive_grid &operator=(adaptive_grid const &) = delete;
+  adaptive_grid(adaptive_grid &&) = default;
+
+  // Moves the grid of other into memory from allocator.
+  adaptive_grid(adaptive_grid &&other, allocator_type const &allocator)
+      : allocator_{allocator}, compact_cell_cost_{other.compact_cell_cost_},
+        hysteresis_{other.hysteresis_}, dense_{other.dense_},
+        switch_count_{other.switch_count_}, occupancy_{other.occupancy_},
+        volume_{other.volume_}, sketch_{std::move(other.sketch_)},
+        elements_{std::move(other.elements_)} {
+    if (other.dense_grid_)
+      dense_grid_.emplace(std::move(*other.dense_grid_), allocator);
+    if (other.compact_grid_)
+      compact_grid_.emplace(std::move(*other.compact_grid_), allocator);
+  }
+
+  // Swaps the contents if the allocators compare equal, otherwise moves the
+  // grid.
+  adaptive_grid &operator=(adaptive_grid &&other) noexcept(
+      std::allocator_traits<allocator_type>::is_always_equal::value) {
+    if (not(allocator_ == other.allocator_))
+      return *this = adaptive_grid{std::move(other), allocator_};
+
+    using std::swap;
+    swap(compact_cell_cost_, other.compact_cell_cost_);
+    swap(hysteresis_, other.hysteresis_);
+    swap(dense_, other.dense_);
+    swap(switch_count_, other.switch_count_);
+    swap(occupancy_, other.occupancy_);
+    swap(volume_, other.volume_);
+    swap(sketch_, other.sketch_);
+    swap(dense_grid_, other.dense_grid_);
+    swap(compact_grid_, other.compact_grid_);
+    swap(elements_, other.elements_);
+    return *this;
+  }
+
+private:
+  allocator_type allocator_;
+  double compact_cell_cost_;
+  double hysteresis_;
+
+  bool dense_ = true;
+  size_t switch_count_ = 0;
+  double occupancy_ = 1;
+  double volume_ = 0;
+
+  static constexpr size_t sketch_size = 256;
+  std::vector<std::uint64_t> sketch_ = {};
+
+  // only the grid of the current representation exists
+  std::optional<dense_grid_type> dense_grid_;
+  std::optional<compact_grid_type> compact_grid_ = std::nullopt;
+
+  std::vector<std::pair<position_type, entry_type>> elements_ = {};
+};
+
+template <size_t NDim>
+using s32_e32_adaptive_grid =
+    adaptive_grid<s32_space_policy<NDim>, u32_entry_policy>;
+
+} // namespace ungrd
+
+#endif // UNGRD_ADAPTIVE_GRID_HPP_42820F19062C48B89AF1B8C88566A394
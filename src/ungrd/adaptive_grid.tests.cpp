@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include "adaptive_grid.hpp"
+#include "grid.tests.hpp"
+#include "slab_memory_resource.hpp"
+
+#include <vector>
+
+using namespace ungrd;
+
+TEST(AdaptiveGrid, Correctness) {
+  T_Grid_Correctness<s32_e32_adaptive_grid<3>>();
+}
+
+TEST(AdaptiveGrid, SlabMemoryResourceCorrectness) {
+  using grid_type = adaptive_grid<
+      s32_space_policy<3>, u32_entry_policy,
+      std::pmr::polymorphic_allocator<u32_entry_policy::entry>>;
+
+  slab_memory_resource resource;
+  T_Grid_Correctness<grid_type>(&resource);
+}
+
+TEST(AdaptiveGrid, SlabMemoryResourceClear) {
+  T_Grid_SlabMemoryResourceClear<adaptive_grid<
+      s32_space_policy<3>, u32_entry_policy,
+      std::pmr::polymorphic_allocator<u32_entry_policy::entry>>>();
+}
+
+TEST(AdaptiveGrid, RandomDifferentialUpdates) {
+  T_Grid_RandomDifferentialUpdates<s32_e32_adaptive_grid<3>>();
+}
+
+TEST(AdaptiveGrid, BoxQuery) { T_Grid_BoxQuery<s32_e32_adaptive_grid<3>>(); }
+
+TEST(AdaptiveGrid, Payload) {
+  T_Grid_Payload<
+      adaptive_grid<s32_space_policy<3>, u32_f32xN_entry_policy<3>>>();
+}
+
+TEST(AdaptiveGrid, TrackedUpdate) {
+  T_Grid_TrackedUpdate<s32_e32_adaptive_grid<3>>();
+}
+
+TEST(AdaptiveGrid, Switching) {
+  using grid_type = s32_e32_adaptive_grid<3>;
+  using position_type = std::array<int, 3>;
+
+  // a 4^3 lattice of cells that are side cells apart
+  auto const lattice = [](int const side) {
+    std::vector<std::pair<position_type, std::uint32_t>> input;
+    for (int x = 0; x < 4; ++x)
+      for (int y = 0; y < 4; ++y)
+        for (int z = 0; z < 4; ++z)
+          input.emplace_back(
+              position_type{x * side, y * side, z * side}, input.size());
+    return input;
+  };
+
+  // the break-even occupancy is 1/4, switches below 1/6 and above 3/8
+  grid_type grid{4., .5};
+  ASSERT_TRUE(grid.is_dense());
+
+  grid.update(lattice(1));
+  ASSERT_TRUE(grid.is_dense());
+  ASSERT_EQ(1., grid.occupancy());
+
+  // occupancy 64 / 7^3 is below 1/4, but not below 1/6
+  grid.update(lattice(2));
+  ASSERT_TRUE(grid.is_dense());
+  ASSERT_EQ(0u, grid.switch_count());
+
+  auto input = lattice(3);
+  grid.update(input);
+  ASSERT_FALSE(grid.is_dense());
+  ASSERT_EQ(1u, grid.switch_count());
+  ASSERT_EQ(64u, grid.count_filled_cells());
+
+  // and back again, by filling the box of 10^3 cells with new entries
+  std::vector<std::pair<position_type, std::uint32_t>> fresh, stale;
+  for (int x = 0; x < 10; ++x)
+    for (int y = 0; y < 10; ++y)
+      for (int z = 0; z < 10; ++z)
+        fresh.emplace_back(position_type{x, y, z}, input.size() + fresh.size());
+  grid.differential_update(fresh, stale);
+  ASSERT_TRUE(grid.is_dense());
+  ASSERT_EQ(2u, grid.switch_count());
+  ASSERT_EQ(1000u, grid.count_filled_cells());
+
+  input.insert(input.end(), fresh.begin(), fresh.end());
+  for (auto const &[cpos, entry] : input) {
+    bool found = false;
+    grid.foreach_entry_at_position(
+        cpos, [&found, entry](auto const other) { found |= other == entry; });
+    ASSERT_TRUE(found);
+  }
+}
+
+TEST(AdaptiveGrid, SwitchesBeforeBuilding) {
+  using grid_type = s32_e32_adaptive_grid<3>;
+  using position_type = std::array<int, 3>;
+
+  // a dense grid for this box of 2^60 cells could not be allocated
+  std::vector<std::pair<position_type, std::uint32_t>> const input = {
+      {{0, 0, 0}, 0}, {{1 << 20, 1 << 20, 1 << 20}, 1}};
+
+  grid_type grid;
+  grid.update(input);
+  ASSERT_FALSE(grid.is_dense());
+  ASSERT_EQ(1u, grid.switch_count());
+  ASSERT_EQ(2u, grid.count_filled_cells());
+
+  std::vector<position_type> cposes;
+  for (auto const &[cpos, entry] : input)
+    cposes.push_back(cpos);
+  grid_type tracked;
+  tracked.tracked_update(cposes);
+  ASSERT_FALSE(tracked.is_dense());
+  ASSERT_EQ(2u, tracked.count_filled_cells());
+}
+
+TEST(AdaptiveGrid, EstimatedFilledCells) {
+  using grid_type = s32_e32_adaptive_grid<3>;
+  using position_type = std::array<int, 3>;
+
+  // 40^3 cells with 4 entries each, every other cell along x is filled
+  auto const input = [](int const side) {
+    std::vector<std::pair<position_type, std::uint32_t>> input;
+    for (int x = 0; x < 40; ++x)
+      for (int y = 0; y < 40; ++y)
+        for (int z = 0; z < 40; ++z)
+          for (int i = 0; i < 4; ++i)
+            input.emplace_back(position_type{x * side, y, z}, input.size());
+    return input;
+  };
+
+  // the estimate is close enough to neither switch at occupancy 1 / 2 nor
+  // stay dense at occupancy 1 / 8
+  grid_type grid{4., .5};
+  grid.update(input(2));
+  ASSERT_TRUE(grid.is_dense());
+  grid.update(input(8));
+  ASSERT_FALSE(grid.is_dense());
+  ASSERT_EQ(64000u, grid.count_filled_cells());
+}
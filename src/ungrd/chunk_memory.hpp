@@ -0,0 +1,91 @@
+#ifndef UNGRD_CHUNK_MEMORY_HPP_607FF5E9AF674FCDA07CB02564A0A788
+#define UNGRD_CHUNK_MEMORY_HPP_607FF5E9AF674FCDA07CB02564A0A788
+
+#include <new>
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace ungrd {
+
+// Provides the memory of object_pool chunks from the global heap.
+struct heap_chunk_memory {
+  static void *allocate(size_t const bytes, size_t const alignment) {
+    return ::operator new(bytes, std::align_val_t{alignment});
+  }
+
+  static void
+  deallocate(void *const memory, size_t const bytes, size_t const alignment) {
+    ::operator delete(memory, bytes, std::align_val_t{alignment});
+  }
+};
+
+// Provides the memory of object_pool chunks in whole 2 MiB huge pages.
+//
+// On Linux the memory is first requested from the reserved huge pages
+// (MAP_HUGETLB). If none are available, a huge page aligned mapping is marked
+// with MADV_HUGEPAGE so that transparent huge pages can back it. Elsewhere this
+// falls back to heap_chunk_memory.
+struct huge_page_chunk_memory {
+  static constexpr size_t huge_page_bytes = size_t{2} << 20;
+
+  static constexpr size_t round_to_huge_pages(size_t const bytes) {
+    return (bytes + huge_page_bytes - 1) / huge_page_bytes * huge_page_bytes;
+  }
+
+#if defined(__linux__)
+  static void *allocate(size_t const bytes, size_t) {
+    auto const mapped_bytes = round_to_huge_pages(bytes);
+
+    constexpr int protection = PROT_READ | PROT_WRITE;
+    constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+    if (void *memory = ::mmap(
+            nullptr, mapped_bytes, protection, flags | MAP_HUGETLB, -1, 0);
+        memory != MAP_FAILED)
+      return memory;
+
+    // over-allocate to be able to align the mapping to a huge page boundary
+    auto const span_bytes = mapped_bytes + huge_page_bytes;
+    void *span = ::mmap(nullptr, span_bytes, protection, flags, -1, 0);
+    if (span == MAP_FAILED)
+      throw std::bad_alloc{};
+
+    auto *const first = static_cast<std::byte *>(span);
+    auto const address = reinterpret_cast<std::uintptr_t>(first);
+    auto const head_bytes = (huge_page_bytes - address % huge_page_bytes) %
+                            huge_page_bytes;
+    auto *const memory = first + head_bytes;
+
+    if (head_bytes > 0)
+      ::munmap(first, head_bytes);
+    if (auto const tail_bytes = span_bytes - head_bytes - mapped_bytes;
+        tail_bytes > 0)
+      ::munmap(memory + mapped_bytes, tail_bytes);
+
+    ::madvise(memory, mapped_bytes, MADV_HUGEPAGE);
+    return memory;
+  }
+
+  static void deallocate(void *const memory, size_t const bytes, size_t) {
+    ::munmap(memory, round_to_huge_pages(bytes));
+  }
+#else
+  static void *allocate(size_t const bytes, size_t const alignment) {
+    return heap_chunk_memory::allocate(bytes, alignment);
+  }
+
+  static void
+  deallocate(void *const memory, size_t const bytes, size_t const alignment) {
+    heap_chunk_memory::deallocate(memory, bytes, alignment);
+  }
+#endif
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_CHUNK_MEMORY_HPP_607FF5E9AF674FCDA07CB02564A0A788
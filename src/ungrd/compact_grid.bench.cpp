@@ -3,6 +3,9 @@
 #include "compact_grid.hpp"
 #include "grid.bench.hpp"
 
+#include <random>
+#include <vector>
+
 using namespace ungrd;
 
 // FirstUpdate
@@ -39,6 +42,14 @@ BENCHMARK_TEMPLATE(
         {EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE,
          RANDOM_ENTRY_RANGE});
 
+// SomeMoveOneTrackedUpdate
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_SomeMoveOneTrackedUpdate_RandomCells, s32_e32_compact_grid<3>)
+    ->Ranges(
+        {EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE,
+         MOVE_COUNT_RANGE});
+
 // CountAllEntries
 
 BENCHMARK_TEMPLATE(BMT_Grid_CountAllEntries_DenseCells, s32_e32_compact_grid<3>)
@@ -47,3 +58,86 @@ BENCHMARK_TEMPLATE(BMT_Grid_CountAllEntries_DenseCells, s32_e32_compact_grid<3>)
 BENCHMARK_TEMPLATE(
     BMT_Grid_CountAllEntries_RandomCells, s32_e32_compact_grid<3>)
     ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+// CountEntriesInBox
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_CountEntriesInBox_RandomCells, s32_e32_compact_grid<3>)
+    ->Ranges(
+        {EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE,
+         BOX_SIDE_RANGE});
+
+// RaysThroughCells
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_RaysThroughCells_RandomCells, s32_e32_compact_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_RayBatchThroughCells_RandomCells, s32_e32_compact_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+// PositionQueries
+
+// Looks up 100k random cells of a grid with about 4M filled cells, one query
+// after the other or as a batch.
+template <bool Batched>
+void BMT_CompactGrid_PositionQueries(benchmark::State &state) {
+  using grid_type = s32_e32_compact_grid<3>;
+  using position_type = grid_type::space_policy::position;
+
+  auto const &input = Grid_RandomCells_Input<grid_type>(state);
+
+  grid_type grid;
+  grid.update(input);
+
+  std::mt19937 gen{3};
+  std::uniform_int_distribution<size_t> dis{0, input.size() - 1};
+
+  std::vector<position_type> cposes(100'000);
+  for (auto &cpos : cposes)
+    cpos = input[dis(gen)].first;
+
+  size_t sum = 0;
+  for (auto _ : state) {
+    if constexpr (Batched) {
+      grid.foreach_entry_at_positions(
+          cposes, [&sum](size_t, auto const entry) { sum += entry; });
+    } else {
+      for (auto const &cpos : cposes)
+        grid.foreach_entry_at_position(
+            cpos, [&sum](auto const entry) { sum += entry; });
+    }
+  }
+  benchmark::DoNotOptimize(sum);
+
+  state.SetItemsProcessed(state.iterations() * cposes.size());
+}
+BENCHMARK_TEMPLATE(BMT_CompactGrid_PositionQueries, false)
+    ->Args({256, 256, 256, 1 << 22})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BMT_CompactGrid_PositionQueries, true)
+    ->Args({256, 256, 256, 1 << 22})
+    ->Unit(benchmark::kMillisecond);
+
+// 16-bit positions and entries
+
+BENCHMARK_TEMPLATE(BMT_Grid_FirstUpdate_DenseCells, s32_e32_compact_grid<3>)
+    ->Ranges(
+        {NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE,
+         NARROW_DENSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(BMT_Grid_FirstUpdate_DenseCells, s16_e16_compact_grid<3>)
+    ->Ranges(
+        {NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE,
+         NARROW_DENSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(BMT_Grid_CountAllEntries_DenseCells, s32_e32_compact_grid<3>)
+    ->Ranges(
+        {NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE,
+         NARROW_DENSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(BMT_Grid_CountAllEntries_DenseCells, s16_e16_compact_grid<3>)
+    ->Ranges(
+        {NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE,
+         NARROW_DENSE_ENTRY_RANGE});
@@ -10,14 +10,26 @@
 
 #include "cxx/assert.hpp"
 #include "cxx/map.hpp"
+#include "cxx/prefetch.hpp"
 #include "cxx/set.hpp"
+#include "entry_cell.hpp"
 #include "entry_policy.hpp"
+#include "entry_tracker.hpp"
+#include "grid_stats.hpp"
 #include "object_pool.hpp"
+#include "packed_entry_cell.hpp"
+#include "ray_traversal.hpp"
 #include "space_policy.hpp"
 
 #include <algorithm>
 #include <array>
+#include <memory>
+#include <memory_resource>
 #include <limits>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <cstddef>
@@ -27,64 +39,50 @@
 
 namespace ungrd {
 
-template <typename PSpace, typename PEntry>
+template <
+    typename PSpace, typename PEntry,
+    typename TAllocator = std::allocator<typename PEntry::entry>>
 class compact_grid {
 public:
   using space_policy = PSpace;
   using entry_policy = PEntry;
+  using allocator_type = TAllocator;
 
 private:
   static constexpr std::size_t ndim = space_policy::ndim;
   using position_type = typename space_policy::position;
+  using position_index_type = typename position_type::value_type;
   using position_hash = boost::hash<position_type>;
 
-  using entry_type = typename entry_policy::entry;
+  static_assert(
+      not space_policy::periodic, "only dense_grid supports periodic spaces");
 
-  using entry_vector = std::vector<entry_type>;
+  using entry_type = typename entry_policy::entry;
 
 private:
   using cidx_type = std::size_t;
 
-  class cell_type {
-  public:
-    bool empty() const { return entries_.empty(); }
-
-    auto const &entries() const { return entries_; }
+  static constexpr bool packed = is_packed_entry_policy<entry_policy>;
 
-    void reserve_entries(size_t count) { entries_.reserve(count); }
+  using cell_type = std::conditional_t<
+      packed, packed_entry_cell<entry_policy, allocator_type>,
+      entry_cell<entry_policy, allocator_type>>;
 
-    void add_entry(entry_type entry) {
-      using std::begin, std::end;
-      auto it = std::find(begin(entries_), end(entries_), entry);
-      if (it == end(entries_))
-        entries_.emplace_back(entry);
-    }
-
-    void erase_entry(entry_type entry) {
-      using std::begin, std::end;
-      auto it = std::find(begin(entries_), end(entries_), entry);
-      if (it != end(entries_))
-        entries_.erase(it);
-    }
+  using tracker_type = entry_tracker<position_type, entry_type>;
 
-    friend void swap(cell_type &a, cell_type &b) {
-      using std::swap;
-      swap(a.entries_, b.entries_);
-    }
-
-  public:
-    cell_type() = default;
+public:
+  size_t count_filled_cells() const { return stats_.filled_cells; }
 
-  private:
-    entry_vector entries_ = {};
-  };
+  grid_stats<position_type> stats() const {
+    auto stats = stats_;
+    std::tie(stats.lo, stats.hi) = bounding_box();
+    return stats;
+  }
 
-public:
-  size_t count_filled_cells() const {
-    size_t count = 0;
-    for (auto const &cell : cells_)
-      count += not cell.empty();
-    return count;
+  // An inclusive box that contains all filled cells. It grows with the cells
+  // that are added and only shrinks with update.
+  std::pair<position_type, position_type> bounding_box() const {
+    return {bounding_box_lo_, bounding_box_hi_};
   }
 
 public:
@@ -92,8 +90,194 @@ public:
   void foreach_entry_at_position(
       position_type const &cpos, FCallback callback) const {
     if (auto it = map_.find(cpos); it != map_.end())
-      for (auto const entry : cells_[it->second].entries())
-        callback(entry);
+      cells_[it->second].foreach_entry(callback);
+  }
+
+  // Calls callback(query, entry) for every entry at the position cposes[query].
+  // The queries run in groups through stages that hash the positions and
+  // prefetch the buckets of the map, probe the map and prefetch the cells,
+  // prefetch the entries of the cells and finally call the callback. The cache
+  // misses of a group overlap instead of stalling one query after the other.
+  template <typename FCallback>
+  void foreach_entry_at_positions(
+      std::span<position_type const> const cposes, FCallback callback) const {
+    constexpr size_t group_size = 16;
+
+    std::array<size_t, group_size> hashes;
+    std::array<cell_type const *, group_size> cells;
+
+    for (size_t first = 0; first < cposes.size(); first += group_size) {
+      auto const group =
+          cposes.subspan(first, std::min(group_size, cposes.size() - first));
+
+      for (size_t i = 0; i < group.size(); ++i) {
+        hashes[i] = hash_position(group[i]);
+        prefetch_map_bucket(hashes[i]);
+      }
+
+      for (size_t i = 0; i < group.size(); ++i) {
+        auto const it = find_position(group[i], hashes[i]);
+        cells[i] = it != map_.end() ? &cells_[it->second] : nullptr;
+        if (cells[i] != nullptr)
+          prefetch(cells[i]);
+      }
+
+      for (size_t i = 0; i < group.size(); ++i)
+        if (cells[i] != nullptr and not cells[i]->empty()) {
+          if constexpr (packed)
+            prefetch(cells[i]->bytes().data());
+          else
+            prefetch(cells[i]->entries().data());
+        }
+
+      for (size_t i = 0; i < group.size(); ++i)
+        if (cells[i] != nullptr)
+          cells[i]->foreach_entry(
+              [&callback, query = first + i](entry_type const entry) {
+                callback(query, entry);
+              });
+    }
+  }
+
+  // Calls callback(entry) for every entry in the cells of the box [lo, hi].
+  template <typename FCallback>
+  void foreach_entry_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    foreach_filled_cell_in_box(lo, hi, [&callback](cell_type const &cell) {
+      cell.foreach_entry(callback);
+    });
+  }
+
+  // Calls callback(view) with an entry_cell_view of every filled cell in the
+  // box [lo, hi]. Packed cells have no views.
+  template <typename FCallback>
+  void foreach_cell_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const
+    requires(not packed)
+  {
+    foreach_filled_cell_in_box(lo, hi, [&callback](cell_type const &cell) {
+      callback(cell.view());
+    });
+  }
+
+private:
+  // Calls callback(cell) for every filled cell in the box [lo, hi]. Small
+  // boxes probe the map for every cell of the box, boxes with more cells than
+  // the map scan the map instead.
+  template <typename FCallback>
+  void foreach_filled_cell_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    // the volume is only compared to the size of the map, saturate above it
+    size_t const cell_count = map_.size();
+    size_t volume = 1;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      if (lo[dim] > hi[dim])
+        return;
+
+      auto const span =
+          static_cast<size_t>(hi[dim]) - static_cast<size_t>(lo[dim]);
+      if (volume > cell_count or span >= cell_count)
+        volume = cell_count + 1;
+      else
+        volume *= span + 1;
+    }
+
+    if (volume <= cell_count) {
+      position_type cpos = lo;
+      while (true) {
+        if (auto it = map_.find(cpos); it != map_.end()) {
+          auto const &cell = cells_[it->second];
+          if (not cell.empty())
+            callback(cell);
+        }
+
+        size_t dim = ndim;
+        while (true) {
+          if (dim == 0)
+            return;
+          --dim;
+
+          if (cpos[dim] < hi[dim]) {
+            ++cpos[dim];
+            break;
+          }
+          cpos[dim] = lo[dim];
+        }
+      }
+    } else {
+      for (auto const &[cpos, cidx] : map_) {
+        bool inside = true;
+        for (size_t dim = 0; dim < ndim; ++dim)
+          inside &= lo[dim] <= cpos[dim] and cpos[dim] <= hi[dim];
+
+        if (inside and not cells_[cidx].empty())
+          callback(cells_[cidx]);
+      }
+    }
+  }
+
+public:
+  // Calls callback(cpos, t_enter, t_exit, entries) for every filled cell that
+  // the segment origin + t * direction, t in [0, t_max], passes through, in
+  // order. Coordinates are in units of the cell size, the traversal stops when
+  // the callback returns false. The segment is clipped to the bounding box and
+  // first steps through the blocks of cells, only the cells of blocks with
+  // filled cells probe the map. Packed cells have no entry arrays to pass.
+  template <typename TReal, typename FCallback>
+  void foreach_cell_along_ray(
+      std::array<TReal, ndim> const &origin,
+      std::array<TReal, ndim> const &direction,
+      std::type_identity_t<TReal> const t_max, FCallback callback) const
+    requires(not packed)
+  {
+    // scaling by a power of two is exact, the blocks are entered at the same
+    // parameters as their first cells
+    constexpr TReal block_scale = TReal{1} / block_extent;
+    std::array<TReal, ndim> block_origin, block_direction;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      block_origin[dim] = origin[dim] * block_scale;
+      block_direction[dim] = direction[dim] * block_scale;
+    }
+
+    ray_traversal<position_type, TReal> block_ray{
+        block_origin, block_direction, t_max, block_of(bounding_box_lo_),
+        block_of(bounding_box_hi_)};
+    if (not block_ray.valid())
+      return;
+
+    do {
+      auto const &block = block_ray.cpos();
+      if (auto it = block_cell_counts_.find(block);
+          it == block_cell_counts_.end() or it->second == 0)
+        continue;
+
+      position_type lo, hi;
+      for (size_t dim = 0; dim < ndim; ++dim) {
+        auto const first = static_cast<position_index_type>(
+            block[dim] * position_index_type{block_extent});
+        lo[dim] = std::max(first, bounding_box_lo_[dim]);
+        hi[dim] = std::min(
+            static_cast<position_index_type>(first + (block_extent - 1)),
+            bounding_box_hi_[dim]);
+      }
+
+      ray_traversal<position_type, TReal> ray{origin, direction, t_max, lo, hi};
+      if (not ray.valid())
+        continue;
+
+      do {
+        if (auto it = map_.find(ray.cpos()); it != map_.end()) {
+          auto const &cell = cells_[it->second];
+          if (not cell.empty() and
+              not callback(
+                  ray.cpos(), ray.t_enter(), ray.t_exit(), cell.entries()))
+            return;
+        }
+      } while (ray.step());
+    } while (block_ray.step());
   }
 
   template <typename FCallback>
@@ -108,11 +292,28 @@ public:
 public:
   template <typename TInput>
   void update(TInput const &input) {
-    using std::size;
-    size_t const entry_count = size(input);
+    if (tracker_)
+      tracker_->invalidate();
+
+    // none of the entries of the previous update are kept, but the cells stay
+    // in the map to be refilled until most of them are empty
+    if (map_.size() / 2 > stats_.filled_cells) {
+      cells_.clear();
+      map_.clear();
+      block_cell_counts_.clear();
+    } else {
+      for (auto const &[cpos, cidx] : map_) {
+        auto &cell = cells_[cidx];
+        if (not cell.empty()) {
+          resize_cell(cpos, cell.size(), 0);
+          cell.clear_entries();
+        }
+      }
+    }
+    stats_.clear();
 
-    cells_.clear();
-    map_.clear();
+    bounding_box_lo_ = space_policy::most_positive_position();
+    bounding_box_hi_ = space_policy::most_negative_position();
 
     std::array<std::pair<position_type, entry_type>, 0> dummy_stale;
     differential_update(input, dummy_stale);
@@ -121,43 +322,182 @@ public:
   }
 
 public:
+  // Updates the grid with the positions of all entries, cposes[entry] is the
+  // cell position of entry. The grid remembers the position of every entry and
+  // only moves the entries whose cell changed. Calling update or
+  // differential_update in between makes the next call rebuild the grid.
+  template <typename TPositions>
+  void tracked_update(TPositions const &cposes)
+    requires std::is_void_v<typename entry_policy::payload>
+  {
+    if (not tracker_)
+      tracker_ = std::make_unique<tracker_type>();
+
+    auto &tracker = *tracker_;
+    if (tracker.track(cposes))
+      differential_update(tracker.fresh(), tracker.stale());
+    else
+      update(tracker.fresh());
+    tracker.validate();
+  }
+
   template <typename TFresh, typename TStale>
   void differential_update(TFresh const &fresh, TStale const &stale) {
-    for (auto const &[cpos, entry] : fresh) {
+    if (tracker_)
+      tracker_->invalidate();
+
+    // remove stale entries first, entries may stay in the same cell
+    for (auto const &element : stale) {
+      if (auto it = map_.find(std::get<0>(element)); it != map_.end()) {
+        auto &cell = cells_[it->second];
+        auto const old_size = cell.size();
+        cell.erase_entry(std::get<1>(element));
+        resize_cell(std::get<0>(element), old_size, cell.size());
+      }
+    }
+
+    for (auto const &element : fresh) {
+      auto const &cpos = std::get<0>(element);
       if (auto it = map_.find(cpos); it != map_.end()) {
         auto &cell = cells_[it->second];
-        cell.add_entry(entry);
+        auto const old_size = cell.size();
+        cell.add_input_entry(element);
+        resize_cell(cpos, old_size, cell.size());
       } else {
-        auto &cell = cells_.emplace_back();
+        auto &cell = cells_.emplace_back(allocator_);
         cell.reserve_entries(50);
-        cell.add_entry(entry);
+        cell.add_input_entry(element);
+        resize_cell(cpos, 0, cell.size());
         map_[cpos] = cells_.size() - 1;
       }
     }
+  }
+
+private:
+  static position_type block_of(position_type const &cpos) {
+    position_type block;
+    for (size_t dim = 0; dim < ndim; ++dim)
+      block[dim] = static_cast<position_index_type>(cpos[dim] >> block_shift);
+    return block;
+  }
+
+  // Updates the statistics and counts the cell of its block once it is
+  // filled, a filled cell also grows the bounding box. Blocks stay in the map
+  // when their count drops to zero.
+  void resize_cell(
+      position_type const &cpos, size_t const old_size, size_t const new_size) {
+    stats_.resize_cell(old_size, new_size);
+    if ((old_size == 0) == (new_size == 0))
+      return;
+
+    auto const block = block_of(cpos);
+    if (new_size == 0) {
+      --block_cell_counts_.find(block)->second;
+      return;
+    }
 
-    for (auto const &[cpos, entry] : stale) {
-      if (auto it = map_.find(cpos); it != map_.end())
-        cells_[it->second].erase_entry(entry);
+    ++block_cell_counts_[block];
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      bounding_box_lo_[dim] = std::min(bounding_box_lo_[dim], cpos[dim]);
+      bounding_box_hi_[dim] = std::max(bounding_box_hi_[dim], cpos[dim]);
     }
   }
 
+  // The map may take the hash of a key to prefetch its bucket and to find the
+  // key without hashing it again, plain hash maps only hash.
+  size_t hash_position(position_type const &cpos) const {
+    if constexpr (requires { map_.hash(cpos); })
+      return map_.hash(cpos);
+    else
+      return map_.hash_function()(cpos);
+  }
+
+  void prefetch_map_bucket([[maybe_unused]] size_t const hash) const {
+    if constexpr (requires { map_.prefetch_hash(hash); })
+      map_.prefetch_hash(hash);
+  }
+
+  auto find_position(
+      position_type const &cpos, [[maybe_unused]] size_t const hash) const {
+    if constexpr (requires { map_.find(cpos, hash); })
+      return map_.find(cpos, hash);
+    else
+      return map_.find(cpos);
+  }
+
+public:
+  allocator_type get_allocator() const { return allocator_; }
+
+  // Drops all cells and frees their memory.
+  void clear() { *this = compact_grid{allocator_}; }
+
 public:
-  compact_grid() {
-    cells_.emplace_back();
+  compact_grid() : compact_grid(allocator_type{}) {}
+
+  explicit compact_grid(allocator_type const &allocator)
+      : allocator_{allocator} {
+    cells_.emplace_back(allocator_);
     map_[invalid_pos] = 0;
   }
 
   compact_grid(compact_grid const &) = delete;
   compact_grid &operator=(compact_grid const &) = delete;
   compact_grid(compact_grid &&) = default;
-  compact_grid &operator=(compact_grid &&) = default;
+
+  // Moves the cells of other into memory from allocator and leaves other
+  // empty.
+  compact_grid(compact_grid &&other, allocator_type const &allocator)
+      : init_{other.init_}, allocator_{allocator},
+        map_{std::move(other.map_)},
+        block_cell_counts_{std::move(other.block_cell_counts_)},
+        cells_{move_cells(std::move(other.cells_), allocator)},
+        bounding_box_lo_{other.bounding_box_lo_},
+        bounding_box_hi_{other.bounding_box_hi_},
+        stats_{std::move(other.stats_)}, tracker_{std::move(other.tracker_)} {
+    other.clear();
+  }
+
+  // Swaps the contents if the allocators compare equal, otherwise moves the
+  // cells.
+  compact_grid &operator=(compact_grid &&other) noexcept(
+      std::allocator_traits<allocator_type>::is_always_equal::value) {
+    if (not(allocator_ == other.allocator_))
+      return *this = compact_grid{std::move(other), allocator_};
+
+    using std::swap;
+    swap(init_, other.init_);
+    swap(map_, other.map_);
+    swap(block_cell_counts_, other.block_cell_counts_);
+    swap(cells_, other.cells_);
+    swap(bounding_box_lo_, other.bounding_box_lo_);
+    swap(bounding_box_hi_, other.bounding_box_hi_);
+    swap(stats_, other.stats_);
+    swap(tracker_, other.tracker_);
+    return *this;
+  }
 
 private:
   bool init_ = false;
 
+  allocator_type allocator_ = {};
+
   hash_map<position_type, cidx_type, position_hash> map_ = {};
+
+  // the number of filled cells in each block of block_extent^ndim cells, rays
+  // step over the blocks without filled cells
+  static constexpr unsigned block_shift = 3;
+  static constexpr int block_extent = 1 << block_shift;
+  hash_map<position_type, size_t, position_hash> block_cell_counts_ = {};
   std::vector<cell_type> cells_ = {};
 
+  position_type bounding_box_lo_ = space_policy::most_positive_position();
+  position_type bounding_box_hi_ = space_policy::most_negative_position();
+
+  grid_stats<position_type> stats_ = {};
+
+  // allocated by the first tracked_update
+  std::unique_ptr<tracker_type> tracker_ = {};
+
   static constexpr position_type invalid_pos =
       space_policy::most_positive_position();
 };
@@ -166,6 +506,19 @@ template <size_t NDim>
 using s32_e32_compact_grid =
     compact_grid<s32_space_policy<NDim>, u32_entry_policy>;
 
+template <size_t NDim>
+using s16_e16_compact_grid =
+    compact_grid<s16_space_policy<NDim>, u16_entry_policy>;
+
+template <size_t NDim>
+using s32_e32_packed_compact_grid =
+    compact_grid<s32_space_policy<NDim>, u32_packed_entry_policy>;
+
+template <size_t NDim>
+using s32_e32_pmr_compact_grid = compact_grid<
+    s32_space_policy<NDim>, u32_entry_policy,
+    std::pmr::polymorphic_allocator<u32_entry_policy::entry>>;
+
 } // namespace ungrd
 
 #endif // UNGRD_COMPACT_GRID_HPP_0420BAB69C7046B7AC6679E57C7A8D81
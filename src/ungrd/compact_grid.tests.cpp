@@ -2,9 +2,110 @@
 
 #include "compact_grid.hpp"
 #include "grid.tests.hpp"
+#include "slab_memory_resource.hpp"
+
+#include <random>
+#include <vector>
 
 using namespace ungrd;
 
 TEST(CompactGrid, Correctness) {
   T_Grid_Correctness<s32_e32_compact_grid<3>>();
 }
+
+TEST(CompactGrid, SlabMemoryResourceCorrectness) {
+  slab_memory_resource resource;
+  T_Grid_Correctness<s32_e32_pmr_compact_grid<3>>(&resource);
+}
+
+TEST(CompactGrid, SlabMemoryResourceClear) {
+  T_Grid_SlabMemoryResourceClear<s32_e32_pmr_compact_grid<3>>();
+}
+
+TEST(CompactGrid, RandomDifferentialUpdates) {
+  T_Grid_RandomDifferentialUpdates<s32_e32_compact_grid<3>>();
+}
+
+TEST(CompactGrid, BoxQuery) { T_Grid_BoxQuery<s32_e32_compact_grid<3>>(); }
+
+TEST(CompactGrid, S16E16BoxQuery) {
+  T_Grid_BoxQuery<s16_e16_compact_grid<3>>();
+}
+
+TEST(CompactGrid, Payload) {
+  T_Grid_Payload<
+      compact_grid<s32_space_policy<3>, u32_f32xN_entry_policy<3>>>();
+}
+
+TEST(CompactGrid, TrackedUpdate) {
+  T_Grid_TrackedUpdate<s32_e32_compact_grid<3>>();
+}
+
+TEST(CompactGrid, S16E16Correctness) {
+  T_Grid_Correctness<s16_e16_compact_grid<3>>();
+}
+
+TEST(CompactGrid, S16E16RandomDifferentialUpdates) {
+  T_Grid_RandomDifferentialUpdates<s16_e16_compact_grid<3>>();
+}
+
+TEST(CompactGrid, S16E16TrackedUpdate) {
+  T_Grid_TrackedUpdate<s16_e16_compact_grid<3>>();
+}
+
+TEST(CompactGrid, BatchedPositionQuery) {
+  using grid_type = s32_e32_compact_grid<3>;
+  using position_type = grid_type::space_policy::position;
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{-5, 5};
+  auto const random_cpos = [&] {
+    return position_type{
+        coordinate_dis(gen), coordinate_dis(gen), coordinate_dis(gen)};
+  };
+
+  std::vector<std::pair<position_type, std::uint32_t>> input;
+  for (std::uint32_t entry = 0; entry < 500; ++entry)
+    input.emplace_back(random_cpos(), entry);
+
+  grid_type grid;
+  grid.update(input);
+
+  // queries that hit and miss, a few more than a multiple of the group size
+  std::vector<position_type> cposes;
+  for (size_t query = 0; query < 1000 + 7; ++query)
+    cposes.push_back(random_cpos());
+
+  std::vector<std::vector<std::uint32_t>> entries(cposes.size());
+  grid.foreach_entry_at_positions(
+      cposes, [&entries](size_t const query, auto const entry) {
+        entries[query].push_back(entry);
+      });
+
+  for (size_t query = 0; query < cposes.size(); ++query) {
+    std::vector<std::uint32_t> expected;
+    grid.foreach_entry_at_position(
+        cposes[query],
+        [&expected](auto const entry) { expected.push_back(entry); });
+    ASSERT_EQ(expected, entries[query]);
+  }
+
+  grid.foreach_entry_at_positions(
+      {}, [](size_t, auto) { FAIL() << "no queries, no entries"; });
+}
+
+TEST(CompactGrid, PackedCorrectness) {
+  T_Grid_Correctness<s32_e32_packed_compact_grid<3>>();
+}
+
+TEST(CompactGrid, PackedRandomDifferentialUpdates) {
+  T_Grid_RandomDifferentialUpdates<s32_e32_packed_compact_grid<3>>();
+}
+
+TEST(CompactGrid, PackedBoxQuery) {
+  T_Grid_BoxQuery<s32_e32_packed_compact_grid<3>>();
+}
+
+TEST(CompactGrid, PackedTrackedUpdate) {
+  T_Grid_TrackedUpdate<s32_e32_packed_compact_grid<3>>();
+}
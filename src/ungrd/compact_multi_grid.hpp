@@ -3,12 +3,17 @@
 
 #include "cxx/assert.hpp"
 #include "cxx/map.hpp"
+#include "cxx/narrow.hpp"
 #include "cxx/set.hpp"
 
+#include "entry_cell.hpp"
+
 #include <algorithm>
 #include <array>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include <cstddef>
@@ -19,14 +24,20 @@
 
 namespace ungrd {
 
-template <typename TEntry, size_t N>
+// TPositionIndex is the type of the coordinates of grid positions, TCellIndex
+// the type of the indices of the cells that every entry keeps. Narrower types
+// save memory, debug builds check that entries and cells fit.
+template <
+    typename TEntry, size_t N, typename TAllocator = std::allocator<TEntry>,
+    typename TPositionIndex = int, typename TCellIndex = unsigned int>
 class CompactMultiGrid {
   static_assert(1 <= N and N <= 3);
 
 public:
   using Entry = TEntry;
-  using CellIndex = unsigned int;
-  using GridPosition = std::array<int, N>;
+  using Allocator = TAllocator;
+  using CellIndex = TCellIndex;
+  using GridPosition = std::array<TPositionIndex, N>;
 
 private:
   using GridPositionHash = boost::hash<GridPosition>;
@@ -61,7 +72,9 @@ public:
     auto &fresh_positions = update_.fresh_positions;
     auto &stale_positions = update_.stale_positions;
 
-    for (Entry entry = 0; entry < entry_count; ++entry) {
+    for (size_t index = 0; index < entry_count; ++index) {
+      auto const entry = narrow<Entry>(index);
+
       // retrieve the current grid positions of entry
       new_entry_positions.clear();
       input.ForeachEntryPosition(
@@ -94,8 +107,8 @@ public:
           cidx = it->second;
         } else {
           // create new cell
-          cidx = cells_.size();
-          cells_.emplace_back(pos);
+          cidx = narrow<CellIndex>(cells_.size());
+          cells_.emplace_back(pos, allocator_);
           map_.emplace(pos, cidx);
         }
         // connect entry and cell
@@ -136,6 +149,66 @@ public:
     }
   }
 
+  // Copies the entries of every cell in the box [lo, hi]. Entries that are in
+  // several cells of the box are copied once per cell.
+  template <typename OutputIt>
+  void CopyBoxEntries(
+      GridPosition const &lo, GridPosition const &hi, OutputIt output) const {
+    auto const copy_cell_entries = [&output](CellData const &cell_data) {
+      for (auto const entry : cell_data.GetEntries())
+        *(output++) = entry;
+    };
+
+    // the volume is only compared to the cell count, saturate above it
+    size_t const cell_count = cells_.size();
+    size_t volume = 1;
+    for (size_t dim = 0; dim < N; ++dim) {
+      if (lo[dim] > hi[dim])
+        return;
+
+      auto const span =
+          static_cast<size_t>(hi[dim]) - static_cast<size_t>(lo[dim]);
+      if (volume > cell_count or span >= cell_count)
+        volume = cell_count + 1;
+      else
+        volume *= span + 1;
+    }
+
+    if (volume <= cell_count) {
+      // probe every position of the box
+      GridPosition pos = lo;
+      while (true) {
+        if (auto it = map_.find(pos); it != map_.end())
+          copy_cell_entries(cells_[it->second]);
+
+        size_t dim = N;
+        while (true) {
+          if (dim == 0)
+            return;
+          --dim;
+
+          if (pos[dim] < hi[dim]) {
+            ++pos[dim];
+            break;
+          }
+          pos[dim] = lo[dim];
+        }
+      }
+    } else {
+      // scan all cells
+      for (auto const &cell_data : cells_) {
+        auto const &pos = cell_data.GetGridPosition();
+
+        bool inside = true;
+        for (size_t dim = 0; dim < N; ++dim)
+          inside &= lo[dim] <= pos[dim] and pos[dim] <= hi[dim];
+
+        if (inside)
+          copy_cell_entries(cell_data);
+      }
+    }
+  }
+
 public:
   auto KnownCells() const {
     return cells_ | boost::adaptors::transformed([](auto const &cell_data) {
@@ -146,10 +219,16 @@ public:
 private:
   class CellData {
   public:
-    CellData(GridPosition const &position) : position_{position} {
+    CellData(GridPosition const &position, Allocator const &allocator)
+        : position_{position}, entries_{allocator} {
       entries_.reserve(50);
     }
 
+    // moves the entries of other into memory from allocator
+    CellData(CellData &&other, Allocator const &allocator)
+        : position_{other.position_},
+          entries_{std::move(other.entries_), allocator} {}
+
   public:
     void AddEntry(Entry const entry) { entries_.emplace_back(entry); }
 
@@ -165,7 +244,7 @@ private:
 
   private:
     GridPosition position_;
-    std::vector<Entry> entries_;
+    std::vector<Entry, Allocator> entries_;
   };
 
   class EntryData {
@@ -190,15 +269,47 @@ private:
     small_sort_set<CellIndex, std::less<CellIndex>, 1> cell_indices_;
   };
 
+public:
+  Allocator GetAllocator() const { return allocator_; }
+
+  // Drops all cells and entries and frees their memory.
+  void Clear() { *this = CompactMultiGrid{allocator_}; }
+
 public:
   CompactMultiGrid() = default;
+  explicit CompactMultiGrid(Allocator const &allocator)
+      : allocator_{allocator} {}
 
   CompactMultiGrid(CompactMultiGrid const &) = delete;
   CompactMultiGrid &operator=(CompactMultiGrid const &) = delete;
   CompactMultiGrid(CompactMultiGrid &&) = default;
-  CompactMultiGrid &operator=(CompactMultiGrid &&) = default;
+
+  // Moves the cells of other into memory from allocator and leaves other
+  // empty.
+  CompactMultiGrid(CompactMultiGrid &&other, Allocator const &allocator)
+      : allocator_{allocator}, map_{std::move(other.map_)},
+        cells_{move_cells(std::move(other.cells_), allocator)},
+        entries_{std::move(other.entries_)} {
+    other.Clear();
+  }
+
+  // Swaps the contents if the allocators compare equal, otherwise moves the
+  // cells.
+  CompactMultiGrid &operator=(CompactMultiGrid &&other) noexcept(
+      std::allocator_traits<Allocator>::is_always_equal::value) {
+    if (not(allocator_ == other.allocator_))
+      return *this = CompactMultiGrid{std::move(other), allocator_};
+
+    using std::swap;
+    swap(map_, other.map_);
+    swap(cells_, other.cells_);
+    swap(entries_, other.entries_);
+    return *this;
+  }
 
 private:
+  Allocator allocator_ = {};
+
   hash_map<GridPosition, CellIndex, GridPositionHash> map_ = {};
   std::vector<CellData> cells_ = {};
   std::vector<EntryData> entries_ = {};
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include "compact_multi_grid.hpp"
+#include "slab_memory_resource.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace ungrd;
+
+namespace {
+
+// every entry covers the box [lo, hi] of grid positions
+template <typename TPosition>
+struct BoxInput {
+  std::vector<std::pair<TPosition, TPosition>> boxes;
+
+  size_t GetEntryCount() const { return boxes.size(); }
+
+  template <typename TEntry, typename FCallback>
+  void ForeachEntryPosition(TEntry const entry, FCallback callback) const {
+    auto const &[lo, hi] = boxes[entry];
+    for (int x = lo[0]; x <= hi[0]; ++x)
+      for (int y = lo[1]; y <= hi[1]; ++y)
+        callback(TPosition{
+            static_cast<typename TPosition::value_type>(x),
+            static_cast<typename TPosition::value_type>(y)});
+  }
+};
+
+// compares the entries of every cell with the boxes of the input
+template <typename Grid>
+void check_boxes(
+    Grid const &grid, BoxInput<typename Grid::GridPosition> const &input) {
+  using position_type = typename Grid::GridPosition;
+  using entry_type = typename Grid::Entry;
+
+  for (int x = -4; x <= 5; ++x) {
+    for (int y = -4; y <= 5; ++y) {
+      position_type const pos{
+          static_cast<typename position_type::value_type>(x),
+          static_cast<typename position_type::value_type>(y)};
+
+      std::vector<entry_type> expected;
+      for (size_t entry = 0; entry < input.boxes.size(); ++entry) {
+        auto const &[lo, hi] = input.boxes[entry];
+        if (lo[0] <= x and x <= hi[0] and lo[1] <= y and y <= hi[1])
+          expected.push_back(static_cast<entry_type>(entry));
+      }
+
+      std::vector<entry_type> entries;
+      grid.CopyCellEntries(pos, std::back_inserter(entries));
+      std::sort(entries.begin(), entries.end());
+      ASSERT_EQ(expected, entries);
+    }
+  }
+}
+
+template <typename Grid>
+BoxInput<typename Grid::GridPosition> make_boxes() {
+  BoxInput<typename Grid::GridPosition> input;
+  input.boxes = {
+      {{-3, -3}, {-1, 0}}, {{-1, -1}, {1, 1}}, {{0, 0}, {0, 0}},
+      {{2, -3}, {4, -2}}};
+  return input;
+}
+
+template <typename Grid>
+void T_CompactMultiGrid_Boxes() {
+  auto input = make_boxes<Grid>();
+
+  Grid grid;
+  grid.Update(input);
+  check_boxes(grid, input);
+
+  // move and grow some of the boxes
+  input.boxes[0] = {{-3, -2}, {-1, 1}};
+  input.boxes[2] = {{0, 0}, {3, 3}};
+  grid.Update(input);
+  check_boxes(grid, input);
+}
+
+} // namespace
+
+TEST(CompactMultiGrid, Boxes) {
+  T_CompactMultiGrid_Boxes<CompactMultiGrid<unsigned, 2>>();
+}
+
+TEST(CompactMultiGrid, NarrowTypes) {
+  using grid_type = CompactMultiGrid<
+      std::uint16_t, 2, std::allocator<std::uint16_t>, std::int16_t,
+      std::uint16_t>;
+
+  static_assert(sizeof(grid_type::GridPosition) == 4);
+  T_CompactMultiGrid_Boxes<grid_type>();
+}
+
+// Clears a grid whose cells live in a slab_memory_resource, releases the
+// resource and fills the grid again, then moves it into another grid and into
+// a grid with a different resource.
+TEST(CompactMultiGrid, SlabMemoryResourceClear) {
+  using grid_type =
+      CompactMultiGrid<unsigned, 2, std::pmr::polymorphic_allocator<unsigned>>;
+
+  static_assert(std::is_move_assignable_v<grid_type>);
+
+  auto const input = make_boxes<grid_type>();
+
+  slab_memory_resource resource;
+  grid_type grid{&resource};
+  grid.Update(input);
+  check_boxes(grid, input);
+
+  grid.Clear();
+  ASSERT_TRUE(grid.KnownCells().empty());
+  resource.release();
+
+  grid.Update(input);
+  check_boxes(grid, input);
+
+  grid_type other{&resource};
+  other = std::move(grid);
+  check_boxes(other, input);
+
+  // the cells must be moved into the other resource before this one is freed
+  slab_memory_resource other_resource;
+  grid_type elsewhere{&other_resource};
+  elsewhere = std::move(other);
+  resource.release();
+  check_boxes(elsewhere, input);
+}
@@ -0,0 +1,284 @@
+#ifndef UNGRD_CONCURRENT_OBJECT_POOL_HPP_93057DD33654415B8F6DDCA98821962E
+#define UNGRD_CONCURRENT_OBJECT_POOL_HPP_93057DD33654415B8F6DDCA98821962E
+
+#include "cxx/map.hpp"
+#include "object_pool.hpp"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace ungrd {
+
+// Thread-safe counterpart of object_pool.
+//
+// Every thread owns two magazines (small stacks of free objects) which serve
+// acquire and release without synchronization. Only whole magazines are
+// exchanged with the shared depot, so the depot lock is taken at most once per
+// NMagazine operations. Since released objects simply go into the magazines of
+// the releasing thread, objects may be released by any thread. The magazines of
+// a thread are returned to the pool when the thread exits.
+template <typename TObject, size_t NMagazine = 64>
+class concurrent_object_pool {
+  static_assert(NMagazine > 0);
+
+public:
+  using object_type = TObject;
+
+  static constexpr size_t magazine_size = NMagazine;
+
+public:
+  size_t count_chunks() const {
+    std::lock_guard lock{depot_mutex_};
+    return chunks_.count_chunks();
+  }
+
+  size_t count_available_chunks() const {
+    std::lock_guard lock{depot_mutex_};
+    return chunks_.count_available_chunks();
+  }
+
+  // Must not be called while other threads use the pool, it reads the
+  // magazines of all threads.
+  size_t count_available_objects() const {
+    std::lock_guard lock{depot_mutex_};
+    size_t count = chunks_.count_available_objects();
+    for (auto const &magazine : full_magazines_)
+      count += magazine->count;
+    for (auto const &cache : caches_)
+      count += cache->loaded->count + cache->previous->count;
+    return count;
+  }
+
+public:
+  TObject *acquire() {
+    auto &cache = local_cache();
+    if (cache.loaded->empty()) {
+      if (cache.previous->full())
+        std::swap(cache.loaded, cache.previous);
+      else
+        cache.loaded = exchange_for_full(std::move(cache.loaded));
+    }
+    return cache.loaded->pop();
+  }
+
+  void release(TObject *object) {
+    auto &cache = local_cache();
+    if (cache.loaded->full()) {
+      if (not cache.previous->empty())
+        cache.previous = exchange_for_empty(std::move(cache.previous));
+      std::swap(cache.loaded, cache.previous);
+    }
+    cache.loaded->push(object);
+  }
+
+public:
+  struct acquire_deleter {
+    void operator()(TObject *object) const { pool->release(object); }
+
+    concurrent_object_pool *pool;
+  };
+
+public:
+  using acquire_unique_ptr = std::unique_ptr<TObject, acquire_deleter>;
+
+  auto acquire_unique() {
+    return acquire_unique_ptr{this->acquire(), acquire_deleter{this}};
+  }
+
+  using acquire_shared_ptr = std::shared_ptr<TObject>;
+
+  auto acquire_shared() {
+    return acquire_shared_ptr{this->acquire(), acquire_deleter{this}};
+  }
+
+public:
+  // Must not be called while other threads use the pool.
+  void clear() {
+    std::lock_guard lock{depot_mutex_};
+    for (auto &cache : caches_) {
+      cache->loaded->count = 0;
+      cache->previous->count = 0;
+    }
+    for (auto &magazine : full_magazines_) {
+      magazine->count = 0;
+      empty_magazines_.emplace_back(std::move(magazine));
+    }
+    full_magazines_.clear();
+    chunks_.clear();
+  }
+
+private:
+  struct magazine_type {
+    std::array<TObject *, NMagazine> objects;
+    size_t count = 0;
+
+    bool empty() const { return count == 0; }
+
+    bool full() const { return count == NMagazine; }
+
+    void push(TObject *object) {
+      assert(not full());
+      objects[count++] = object;
+    }
+
+    TObject *pop() {
+      assert(not empty());
+      return objects[--count];
+    }
+  };
+
+  using magazine_ptr = std::unique_ptr<magazine_type>;
+
+  struct thread_cache {
+    magazine_ptr loaded = std::make_unique<magazine_type>();
+    magazine_ptr previous = std::make_unique<magazine_type>();
+  };
+
+private:
+  magazine_ptr exchange_for_full(magazine_ptr empty) {
+    std::lock_guard lock{depot_mutex_};
+    empty_magazines_.emplace_back(std::move(empty));
+
+    if (not full_magazines_.empty()) {
+      auto full = std::move(full_magazines_.back());
+      full_magazines_.pop_back();
+      return full;
+    }
+
+    auto full = std::move(empty_magazines_.back());
+    empty_magazines_.pop_back();
+    chunks_.acquire_n(NMagazine, full->objects.data());
+    full->count = NMagazine;
+    return full;
+  }
+
+  magazine_ptr exchange_for_empty(magazine_ptr full) {
+    std::lock_guard lock{depot_mutex_};
+    full_magazines_.emplace_back(std::move(full));
+
+    if (empty_magazines_.empty())
+      return std::make_unique<magazine_type>();
+
+    auto empty = std::move(empty_magazines_.back());
+    empty_magazines_.pop_back();
+    return empty;
+  }
+
+private:
+  thread_cache &local_cache() {
+    thread_local struct {
+      std::uint64_t pool_id = 0;
+      thread_cache *cache = nullptr;
+    } last;
+
+    if (last.pool_id != id_) {
+      last.cache = &lookup_cache();
+      last.pool_id = id_;
+    }
+    return *last.cache;
+  }
+
+  // The caches of the calling thread by pool id. Pool ids are never reused, so
+  // entries of destroyed pools are never hit.
+  struct thread_caches {
+    hash_map<std::uint64_t, thread_cache *> caches;
+
+    // returns the objects of the exiting thread to the pools that still exist
+    ~thread_caches() {
+      std::lock_guard lock{live_pools_mutex()};
+      for (auto const &[id, cache] : caches)
+        if (auto it = live_pools().find(id); it != live_pools().end())
+          it->second->flush_cache(cache);
+    }
+  };
+
+  thread_cache &lookup_cache() {
+    thread_local thread_caches local;
+
+    auto [it, inserted] = local.caches.try_emplace(id_, nullptr);
+    if (inserted) {
+      std::lock_guard lock{depot_mutex_};
+      it->second = caches_.emplace_back(std::make_unique<thread_cache>()).get();
+    }
+    return *it->second;
+  }
+
+  // Releases the objects of the cache to the chunks and drops the cache.
+  void flush_cache(thread_cache *cache) {
+    std::lock_guard lock{depot_mutex_};
+    for (auto const *magazine : {cache->loaded.get(), cache->previous.get()})
+      chunks_.release_n(
+          std::span{magazine->objects.data(), magazine->count});
+    std::erase_if(caches_, [cache](auto const &other) {
+      return other.get() == cache;
+    });
+  }
+
+  // The pools that exist, so that exiting threads only flush their caches
+  // into those. Pools are added and removed only on construction and
+  // destruction.
+  static std::mutex &live_pools_mutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static hash_map<std::uint64_t, concurrent_object_pool *> &live_pools() {
+    static hash_map<std::uint64_t, concurrent_object_pool *> pools;
+    return pools;
+  }
+
+public:
+  concurrent_object_pool() {
+    std::lock_guard lock{live_pools_mutex()};
+    live_pools().emplace(id_, this);
+  }
+
+  concurrent_object_pool(concurrent_object_pool const &) = delete;
+  concurrent_object_pool &operator=(concurrent_object_pool const &) = delete;
+
+  ~concurrent_object_pool() {
+    std::lock_guard lock{live_pools_mutex()};
+    live_pools().erase(id_);
+  }
+
+private:
+  static inline std::atomic<std::uint64_t> next_id_ = 1;
+
+  std::uint64_t const id_ = next_id_++;
+
+  mutable std::mutex depot_mutex_;
+  object_pool<TObject> chunks_;
+  std::vector<magazine_ptr> full_magazines_;
+  std::vector<magazine_ptr> empty_magazines_;
+  std::vector<std::unique_ptr<thread_cache>> caches_;
+};
+
+template <typename TObject>
+concurrent_object_pool<TObject> &get_concurrent_object_pool() {
+  static auto the_pool = std::make_unique<concurrent_object_pool<TObject>>();
+  return *the_pool;
+}
+
+template <typename TObject>
+TObject *acquire_concurrent_object() {
+  auto *object = get_concurrent_object_pool<TObject>().acquire();
+  return object;
+}
+
+template <typename TObject>
+void release_concurrent_object(TObject *object) {
+  get_concurrent_object_pool<TObject>().release(object);
+}
+
+} // namespace ungrd
+
+#endif // UNGRD_CONCURRENT_OBJECT_POOL_HPP_93057DD33654415B8F6DDCA98821962E
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include "concurrent_object_pool.hpp"
+#include "cxx/set.hpp"
+
+#include <thread>
+#include <vector>
+
+#include <omp.h>
+
+using namespace ungrd;
+
+TEST(ConcurrentObjectPool, CrossThreadRelease) {
+  concurrent_object_pool<std::array<int, 4>, 8> pool;
+
+  constexpr size_t objects_per_thread = 1000;
+  size_t const thread_count = omp_get_max_threads();
+
+  std::vector<std::vector<std::array<int, 4> *>> acquired(thread_count);
+
+  for (size_t round = 0; round < 3; ++round) {
+#pragma omp parallel num_threads(thread_count)
+    {
+      auto &objects = acquired[omp_get_thread_num()];
+      for (size_t index = 0; index < objects_per_thread; ++index)
+        objects.emplace_back(pool.acquire());
+    }
+
+    hash_set<std::array<int, 4> *> distinct;
+    for (auto const &objects : acquired)
+      for (auto *object : objects)
+        distinct.insert(object);
+    ASSERT_EQ(thread_count * objects_per_thread, distinct.size());
+
+    // release the objects of the neighbouring thread
+#pragma omp parallel num_threads(thread_count)
+    {
+      auto const thread = omp_get_thread_num();
+      auto &objects = acquired[(thread + 1) % thread_count];
+      for (auto *object : objects)
+        pool.release(object);
+    }
+
+    for (auto &objects : acquired)
+      objects.clear();
+  }
+
+  ASSERT_LE(thread_count * objects_per_thread, pool.count_available_objects());
+}
+
+// Objects in the magazines of exited threads go back to the pool, so threads
+// that come and go keep reusing the same chunk.
+TEST(ConcurrentObjectPool, ThreadExitReturnsObjects) {
+  concurrent_object_pool<std::array<int, 4>, 8> pool;
+
+  for (size_t round = 0; round < 100; ++round) {
+    std::thread thread{[&pool] { pool.release(pool.acquire()); }};
+    thread.join();
+  }
+
+  ASSERT_EQ(1u, pool.count_chunks());
+}
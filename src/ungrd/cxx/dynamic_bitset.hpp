@@ -0,0 +1,205 @@
+#ifndef UNGRD_DYNAMIC_BITSET_HPP_4CDE05A6267F4CA8BB6ADD35D1D09662
+#define UNGRD_DYNAMIC_BITSET_HPP_4CDE05A6267F4CA8BB6ADD35D1D09662
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+#include <cstddef>
+
+namespace ungrd {
+
+// Runtime sized counterpart of static_bitset. Bits past size() are always zero,
+// so the bulk operations can work on whole chunks.
+template <std::unsigned_integral TChunk = size_t>
+class dynamic_bitset {
+public:
+  using chunk_type = TChunk;
+
+private:
+  static constexpr size_t chunk_bits = sizeof(chunk_type) * 8;
+
+  static constexpr chunk_type chunk_all_set =
+      std::numeric_limits<chunk_type>::max();
+
+  static constexpr size_t get_chunk_count(size_t const bit_count) {
+    return (bit_count + chunk_bits - 1) / chunk_bits;
+  }
+
+  constexpr auto get_bit_position(size_t const index) const {
+    size_t const chunk_index = index / chunk_bits;
+    size_t const bit_index = index % chunk_bits;
+    assert(index < size_);
+    return std::make_pair(chunk_index, bit_index);
+  }
+
+  constexpr static chunk_type get_chunk_mask(size_t const bit_index) {
+    return chunk_type{1} << bit_index;
+  }
+
+  constexpr void clear_unused_bits() {
+    if (auto const bit_count = size_ % chunk_bits; bit_count != 0)
+      chunks_.back() &= get_chunk_mask(bit_count) - 1;
+  }
+
+public:
+  constexpr size_t size() const { return size_; }
+
+  // new bits are reset
+  constexpr void resize(size_t const bit_count) {
+    chunks_.resize(get_chunk_count(bit_count), 0);
+    size_ = bit_count;
+    clear_unused_bits();
+  }
+
+public:
+  constexpr bool any() const {
+    return std::any_of(
+        chunks_.begin(), chunks_.end(), [](auto &chunk) { return chunk != 0; });
+  }
+
+  constexpr bool none() const { return not any(); }
+
+public:
+  constexpr size_t count_set_bits() const {
+    auto const *chunks = chunks_.data();
+    auto const chunk_count = chunks_.size();
+
+    size_t count = 0;
+#pragma omp simd reduction(+ : count)
+    for (size_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+      count += std::popcount(chunks[chunk_index]);
+    return count;
+  }
+
+public:
+  constexpr bool get(size_t const index) const {
+    auto [chunk_index, bit_index] = get_bit_position(index);
+    auto const mask = get_chunk_mask(bit_index);
+    return chunks_[chunk_index] & mask;
+  }
+
+public:
+  constexpr void set_to(size_t const index, bool const value) {
+    auto [chunk_index, bit_index] = get_bit_position(index);
+    auto const mask = get_chunk_mask(bit_index);
+    if (value)
+      chunks_[chunk_index] |= mask;
+    else
+      chunks_[chunk_index] &= ~mask;
+  }
+
+public:
+  constexpr void set(size_t const index) { set_to(index, true); }
+
+  constexpr void reset(size_t const index) { set_to(index, false); }
+
+public:
+  constexpr void set_all_to(bool const value = true) {
+    std::fill(chunks_.begin(), chunks_.end(), value ? chunk_all_set : 0);
+    clear_unused_bits();
+  }
+
+public:
+  constexpr void set_all() { set_all_to(true); }
+
+  constexpr void reset_all() { set_all_to(false); }
+
+public:
+  // Calls callback with the index of every set bit in ascending order. Every
+  // chunk is visited once, the bits of a chunk are found by repeatedly
+  // counting the trailing zeros and clearing the lowest set bit.
+  template <typename FCallback>
+  constexpr void foreach_set_bit(FCallback callback) const {
+    for (size_t chunk_index = 0; chunk_index < chunks_.size(); ++chunk_index) {
+      auto chunk = chunks_[chunk_index];
+      while (chunk != 0) {
+        size_t const bit_index = std::countr_zero(chunk);
+        callback(chunk_index * chunk_bits + bit_index);
+        chunk &= chunk - 1;
+      }
+    }
+  }
+
+  // Like foreach_set_bit, but only visits the bits in [first, last).
+  template <typename FCallback>
+  constexpr void foreach_set_bit_in_range(
+      size_t const first, size_t const last, FCallback callback) const {
+    if (first >= last)
+      return;
+    assert(last <= size_);
+
+    size_t const first_chunk = first / chunk_bits;
+    size_t const last_chunk = (last - 1) / chunk_bits;
+
+    for (size_t chunk_index = first_chunk; chunk_index <= last_chunk;
+         ++chunk_index) {
+      auto chunk = chunks_[chunk_index];
+      if (chunk_index == first_chunk)
+        chunk &= ~(get_chunk_mask(first % chunk_bits) - 1);
+      if (chunk_index == last_chunk and last % chunk_bits != 0)
+        chunk &= get_chunk_mask(last % chunk_bits) - 1;
+
+      while (chunk != 0) {
+        size_t const bit_index = std::countr_zero(chunk);
+        callback(chunk_index * chunk_bits + bit_index);
+        chunk &= chunk - 1;
+      }
+    }
+  }
+
+public:
+  constexpr dynamic_bitset &operator|=(dynamic_bitset const &other) {
+    assert(size_ == other.size_);
+    auto *chunks = chunks_.data();
+    auto const *other_chunks = other.chunks_.data();
+    auto const chunk_count = chunks_.size();
+#pragma omp simd
+    for (size_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+      chunks[chunk_index] |= other_chunks[chunk_index];
+    return *this;
+  }
+
+  constexpr dynamic_bitset &operator&=(dynamic_bitset const &other) {
+    assert(size_ == other.size_);
+    auto *chunks = chunks_.data();
+    auto const *other_chunks = other.chunks_.data();
+    auto const chunk_count = chunks_.size();
+#pragma omp simd
+    for (size_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+      chunks[chunk_index] &= other_chunks[chunk_index];
+    return *this;
+  }
+
+public:
+  constexpr size_t count_chunks() const { return chunks_.size(); }
+
+  static constexpr size_t bits_per_chunk() { return chunk_bits; }
+
+  constexpr chunk_type get_chunk(size_t const chunk_index) const {
+    return chunks_[chunk_index];
+  }
+
+public:
+  dynamic_bitset() = default;
+
+  explicit dynamic_bitset(size_t const bit_count) { resize(bit_count); }
+
+  friend void swap(dynamic_bitset &a, dynamic_bitset &b) {
+    using std::swap;
+    swap(a.size_, b.size_);
+    swap(a.chunks_, b.chunks_);
+  }
+
+private:
+  size_t size_ = 0;
+  std::vector<chunk_type> chunks_ = {};
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_DYNAMIC_BITSET_HPP_4CDE05A6267F4CA8BB6ADD35D1D09662
@@ -0,0 +1,60 @@
+#include "dynamic_bitset.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(DynamicBitset, Correctness) {
+  ungrd::dynamic_bitset<> bits{130};
+  ASSERT_EQ(130, bits.size());
+  ASSERT_TRUE(bits.none());
+
+  bits.set_all();
+  ASSERT_EQ(130, bits.count_set_bits());
+  ASSERT_TRUE(bits.any());
+
+  bits.reset_all();
+  ASSERT_EQ(0, bits.count_set_bits());
+
+  for (size_t index : {0, 7, 63, 64, 100, 129})
+    bits.set(index);
+  ASSERT_EQ(6, bits.count_set_bits());
+  ASSERT_TRUE(bits.get(64));
+  ASSERT_FALSE(bits.get(65));
+
+  std::vector<size_t> indices;
+  bits.foreach_set_bit([&indices](auto index) { indices.push_back(index); });
+  ASSERT_EQ((std::vector<size_t>{0, 7, 63, 64, 100, 129}), indices);
+
+  indices.clear();
+  bits.foreach_set_bit_in_range(
+      7, 100, [&indices](auto index) { indices.push_back(index); });
+  ASSERT_EQ((std::vector<size_t>{7, 63, 64}), indices);
+
+  indices.clear();
+  bits.foreach_set_bit_in_range(
+      8, 63, [&indices](auto index) { indices.push_back(index); });
+  ASSERT_TRUE(indices.empty());
+
+  ungrd::dynamic_bitset<> other{130};
+  other.set(7);
+  other.set(8);
+
+  auto intersection = bits;
+  intersection &= other;
+  ASSERT_EQ(1, intersection.count_set_bits());
+  ASSERT_TRUE(intersection.get(7));
+
+  auto union_ = bits;
+  union_ |= other;
+  ASSERT_EQ(7, union_.count_set_bits());
+
+  // growing keeps the old bits and resets the new ones
+  bits.resize(200);
+  ASSERT_EQ(6, bits.count_set_bits());
+  ASSERT_FALSE(bits.get(150));
+
+  // shrinking drops the bits past the new size
+  bits.resize(64);
+  ASSERT_EQ(3, bits.count_set_bits());
+}
@@ -0,0 +1,100 @@
+#ifndef UNGRD_FAST_DIVISOR_HPP_54931D8AF4114127AA6DA126C436C186
+#define UNGRD_FAST_DIVISOR_HPP_54931D8AF4114127AA6DA126C436C186
+
+#include <bit>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace ungrd {
+
+// Divides 64-bit unsigned integers by a fixed divisor with a multiplication
+// and shifts instead of a division, using the round-up method by Granlund and
+// Montgomery (as in libdivide's branchfree u64 algorithm):
+//
+//   q = (t + ((n - t) >> shift1)) >> shift2,  t = mulhi(multiplier, n)
+class fast_divisor {
+  static constexpr std::uint64_t
+  mulhi(std::uint64_t const a, std::uint64_t const b) {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<std::uint64_t>(
+        (static_cast<unsigned __int128>(a) * b) >> 64);
+#else
+    std::uint64_t const a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+    std::uint64_t const b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+    std::uint64_t const lo_lo = a_lo * b_lo;
+    std::uint64_t const hi_lo = a_hi * b_lo;
+    std::uint64_t const lo_hi = a_lo * b_hi;
+    std::uint64_t const hi_hi = a_hi * b_hi;
+    std::uint64_t const cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    return hi_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+  }
+
+  // floor(hi * 2^64 / d) for hi < d
+  static constexpr std::uint64_t
+  divide_shifted(std::uint64_t const hi, std::uint64_t const d) {
+    assert(hi < d);
+#if defined(__SIZEOF_INT128__)
+    return static_cast<std::uint64_t>(
+        (static_cast<unsigned __int128>(hi) << 64) / d);
+#else
+    // restoring long division, only used while constructing the divisor
+    std::uint64_t remainder = hi;
+    std::uint64_t quotient = 0;
+    for (int bit = 63; bit >= 0; --bit) {
+      bool const carry = remainder >> 63;
+      remainder <<= 1;
+      quotient <<= 1;
+      if (carry or remainder >= d) {
+        remainder -= d;
+        quotient |= 1;
+      }
+    }
+    return quotient;
+#endif
+  }
+
+public:
+  constexpr std::uint64_t divisor() const { return divisor_; }
+
+  constexpr std::uint64_t divide(std::uint64_t const n) const {
+    auto const t = mulhi(multiplier_, n);
+    return (t + ((n - t) >> shift1_)) >> shift2_;
+  }
+
+  constexpr std::uint64_t modulo(std::uint64_t const n) const {
+    return n - divide(n) * divisor_;
+  }
+
+public:
+  constexpr fast_divisor() : fast_divisor(1) {}
+
+  constexpr explicit fast_divisor(std::uint64_t const d) : divisor_{d} {
+    assert(d > 0);
+    if (d == 1) {
+      multiplier_ = 0;
+      shift1_ = 0;
+      shift2_ = 0;
+    } else {
+      // l = ceil(log2(d)), 2^l - d is computed modulo 2^64
+      unsigned const l = std::bit_width(d - 1);
+      std::uint64_t const two_l_minus_d =
+          (l == 64 ? std::uint64_t{0} : std::uint64_t{1} << l) - d;
+      multiplier_ = divide_shifted(two_l_minus_d, d) + 1;
+      shift1_ = 1;
+      shift2_ = l - 1;
+    }
+  }
+
+private:
+  std::uint64_t divisor_;
+  std::uint64_t multiplier_;
+  unsigned shift1_;
+  unsigned shift2_;
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_FAST_DIVISOR_HPP_54931D8AF4114127AA6DA126C436C186
@@ -0,0 +1,164 @@
+#ifndef UNGRD_HIERARCHICAL_STATIC_BITSET_HPP_C6A1DF095559423BBEEF943C937E7147
+#define UNGRD_HIERARCHICAL_STATIC_BITSET_HPP_C6A1DF095559423BBEEF943C937E7147
+
+#include "static_bitset.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <limits>
+#include <type_traits>
+
+#include <cassert>
+
+namespace ungrd {
+
+// A static_bitset with summary bits: one bitset records which chunks are full,
+// another which chunks are non-empty. Finding the first set or unset bit as
+// well as all() and any() then only look at the summary and a single chunk.
+// Summaries of more than one chunk are hierarchical themselves.
+template <size_t NBits, std::unsigned_integral TChunk = size_t>
+class hierarchical_static_bitset {
+  static_assert(NBits > 0);
+
+public:
+  using chunk_type = TChunk;
+
+private:
+  static constexpr size_t chunk_bits = sizeof(chunk_type) * 8;
+  static constexpr size_t chunk_count = (NBits + chunk_bits - 1) / chunk_bits;
+
+  static constexpr chunk_type chunk_all_set =
+      std::numeric_limits<chunk_type>::max();
+
+  static constexpr chunk_type last_chunk_mask = [] {
+    size_t const bit_count = NBits % chunk_bits;
+    if (bit_count == 0)
+      return chunk_all_set;
+    return static_cast<chunk_type>((chunk_type{1} << bit_count) - 1);
+  }();
+
+  using summary_type = std::conditional_t<
+      (chunk_count <= chunk_bits), static_bitset<chunk_count, chunk_type>,
+      hierarchical_static_bitset<chunk_count, chunk_type>>;
+
+  constexpr static auto get_bit_position(size_t const index) {
+    size_t const chunk_index = index / chunk_bits;
+    size_t const bit_index = index % chunk_bits;
+    assert(chunk_index < chunk_count);
+    return std::make_pair(chunk_index, bit_index);
+  }
+
+  constexpr static chunk_type get_chunk_mask(size_t const bit_index) {
+    return chunk_type{1} << bit_index;
+  }
+
+  constexpr void update_summary(size_t const chunk_index) {
+    auto const chunk = chunks_[chunk_index];
+    full_.set_to(
+        chunk_index, chunk == get_chunk_mask_of_valid_bits(chunk_index));
+    non_empty_.set_to(chunk_index, chunk != 0);
+  }
+
+public:
+  constexpr size_t size() const { return NBits; }
+
+public:
+  constexpr bool all() const { return full_.all(); }
+
+  constexpr bool any() const { return non_empty_.any(); }
+
+  constexpr bool none() const { return not any(); }
+
+public:
+  constexpr size_t count_set_bits() const {
+    size_t count = 0;
+    for (auto const chunk : chunks_)
+      count += std::popcount(chunk);
+    return count;
+  }
+
+public:
+  constexpr bool get(size_t const index) const {
+    auto [chunk_index, bit_index] = get_bit_position(index);
+    auto const mask = get_chunk_mask(bit_index);
+    return chunks_[chunk_index] & mask;
+  }
+
+public:
+  constexpr void set_to(size_t const index, bool const value) {
+    auto [chunk_index, bit_index] = get_bit_position(index);
+    auto const mask = get_chunk_mask(bit_index);
+    if (value)
+      chunks_[chunk_index] |= mask;
+    else
+      chunks_[chunk_index] &= ~mask;
+    update_summary(chunk_index);
+  }
+
+public:
+  constexpr void set(size_t const index) { set_to(index, true); }
+
+  constexpr void reset(size_t const index) { set_to(index, false); }
+
+public:
+  constexpr void set_all_to(bool const value = true) {
+    chunks_.fill(value ? chunk_all_set : 0);
+    chunks_.back() &= last_chunk_mask;
+    full_.set_all_to(value);
+    non_empty_.set_all_to(value);
+  }
+
+public:
+  constexpr void set_all() { set_all_to(true); }
+
+  constexpr void reset_all() { set_all_to(false); }
+
+public:
+  constexpr size_t countr_zero() const {
+    size_t const chunk_index = non_empty_.countr_zero();
+    if (chunk_index >= chunk_count)
+      return NBits;
+    return chunk_index * chunk_bits + std::countr_zero(chunks_[chunk_index]);
+  }
+
+  constexpr size_t countr_one() const {
+    size_t const chunk_index = full_.countr_one();
+    if (chunk_index >= chunk_count)
+      return NBits;
+    return chunk_index * chunk_bits + std::countr_one(chunks_[chunk_index]);
+  }
+
+public:
+  static constexpr size_t count_chunks() { return chunk_count; }
+
+  static constexpr size_t bits_per_chunk() { return chunk_bits; }
+
+  // mask of the bits in the chunk that belong to the bitset
+  static constexpr chunk_type get_chunk_mask_of_valid_bits(
+      size_t const chunk_index) {
+    assert(chunk_index < chunk_count);
+    return chunk_index + 1 < chunk_count ? chunk_all_set : last_chunk_mask;
+  }
+
+  constexpr chunk_type get_chunk(size_t const chunk_index) const {
+    assert(chunk_index < chunk_count);
+    return chunks_[chunk_index];
+  }
+
+  constexpr void set_chunk(size_t const chunk_index, chunk_type const chunk) {
+    assert(chunk_index < chunk_count);
+    chunks_[chunk_index] = chunk & get_chunk_mask_of_valid_bits(chunk_index);
+    update_summary(chunk_index);
+  }
+
+private:
+  std::array<chunk_type, chunk_count> chunks_ = {};
+  summary_type full_ = {};
+  summary_type non_empty_ = {};
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_HIERARCHICAL_STATIC_BITSET_HPP_C6A1DF095559423BBEEF943C937E7147
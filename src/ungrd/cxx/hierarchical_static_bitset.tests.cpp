@@ -0,0 +1,84 @@
+#include "hierarchical_static_bitset.hpp"
+#include "static_bitset.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+template <size_t NBits>
+void T_HierarchicalStaticBitset_MatchesStaticBitset() {
+  std::mt19937 gen{NBits};
+  std::uniform_int_distribution<size_t> index_dis{0, NBits - 1};
+  std::bernoulli_distribution value_dis{0.3};
+
+  ungrd::static_bitset<NBits> expected;
+  ungrd::hierarchical_static_bitset<NBits> bits;
+
+  auto const check = [&] {
+    ASSERT_EQ(expected.all(), bits.all());
+    ASSERT_EQ(expected.any(), bits.any());
+    ASSERT_EQ(not expected.any(), bits.none());
+    ASSERT_EQ(expected.countr_zero(), bits.countr_zero());
+    ASSERT_EQ(expected.countr_one(), bits.countr_one());
+    ASSERT_EQ(expected.count_set_bits(), bits.count_set_bits());
+  };
+
+  check();
+
+  // fill up from the front, then randomly flip bits
+  for (size_t index = 0; index < NBits; index += 1 + index / 3) {
+    expected.set(index);
+    bits.set(index);
+    check();
+  }
+
+  bits.set_all();
+  expected.set_all();
+  check();
+
+  for (size_t round = 0; round < 1000; ++round) {
+    auto const index = index_dis(gen);
+    auto const value = value_dis(gen);
+    expected.set_to(index, value);
+    bits.set_to(index, value);
+    ASSERT_EQ(expected.get(index), bits.get(index));
+    check();
+  }
+
+  bits.reset_all();
+  expected.reset_all();
+  check();
+}
+
+TEST(HierarchicalStaticBitset, Correctness) {
+  ungrd::hierarchical_static_bitset<65, std::uintmax_t> bits;
+  ASSERT_EQ(65, bits.size());
+
+  bits.set_all();
+  ASSERT_EQ(65, bits.count_set_bits());
+  ASSERT_TRUE(bits.all());
+  ASSERT_TRUE(bits.any());
+  ASSERT_FALSE(bits.none());
+  ASSERT_EQ(65, bits.countr_one());
+
+  bits.reset(64);
+  ASSERT_FALSE(bits.all());
+  ASSERT_EQ(64, bits.countr_one());
+
+  bits.reset_all();
+  ASSERT_TRUE(bits.none());
+  ASSERT_EQ(65, bits.countr_zero());
+
+  bits.set(64);
+  ASSERT_EQ(64, bits.countr_zero());
+  ASSERT_EQ(0, bits.countr_one());
+}
+
+TEST(HierarchicalStaticBitset, MatchesStaticBitset) {
+  T_HierarchicalStaticBitset_MatchesStaticBitset<1>();
+  T_HierarchicalStaticBitset_MatchesStaticBitset<64>();
+  T_HierarchicalStaticBitset_MatchesStaticBitset<65>();
+  T_HierarchicalStaticBitset_MatchesStaticBitset<4096>();
+  T_HierarchicalStaticBitset_MatchesStaticBitset<4099>();
+  T_HierarchicalStaticBitset_MatchesStaticBitset<65536>();
+}
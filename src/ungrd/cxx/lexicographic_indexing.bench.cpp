@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include "lexicographic_indexing.hpp"
+#include "static_lexicographic_indexing.hpp"
+
+// the decode implementation before reciprocals and shifts were used
+template <size_t NDim>
+auto division_decode(
+    std::array<size_t, NDim> const &extents, size_t index) {
+  std::array<size_t, NDim> ndidx;
+  for (size_t dim = NDim - 1; dim >= 1; --dim) {
+    ndidx[dim] = index % extents[dim];
+    index = index / extents[dim];
+  }
+  ndidx[0] = index;
+  return ndidx;
+}
+
+#define EXTENT_ARGS                                                            \
+  Args({32, 32, 32})->Args({64, 64, 64})->Args({33, 35, 37})->Args(            \
+      {100, 100, 100})
+
+static void BM_LexicographicIndexing_DivisionDecode(benchmark::State &state) {
+  std::array<size_t, 3> const extents{
+      static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)),
+      static_cast<size_t>(state.range(2))};
+  ungrd::lexicographic_indexing<3> const indexing{extents};
+
+  for (auto _ : state) {
+    for (size_t index = 0; index < indexing.size(); ++index)
+      benchmark::DoNotOptimize(division_decode(extents, index));
+  }
+
+  state.SetItemsProcessed(state.iterations() * indexing.size());
+}
+BENCHMARK(BM_LexicographicIndexing_DivisionDecode)->EXTENT_ARGS;
+
+static void BM_LexicographicIndexing_Decode(benchmark::State &state) {
+  std::array<size_t, 3> const extents{
+      static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)),
+      static_cast<size_t>(state.range(2))};
+  ungrd::lexicographic_indexing<3> const indexing{extents};
+
+  for (auto _ : state) {
+    for (size_t index = 0; index < indexing.size(); ++index)
+      benchmark::DoNotOptimize(indexing.decode(index));
+  }
+
+  state.SetItemsProcessed(state.iterations() * indexing.size());
+}
+BENCHMARK(BM_LexicographicIndexing_Decode)->EXTENT_ARGS;
+
+template <size_t... NExtents>
+static void BMT_StaticLexicographicIndexing_Decode(benchmark::State &state) {
+  using indexing_type = ungrd::static_lexicographic_indexing<NExtents...>;
+
+  for (auto _ : state) {
+    for (size_t index = 0; index < indexing_type::size(); ++index)
+      benchmark::DoNotOptimize(indexing_type::decode(index));
+  }
+
+  state.SetItemsProcessed(state.iterations() * indexing_type::size());
+}
+BENCHMARK_TEMPLATE(BMT_StaticLexicographicIndexing_Decode, 32, 32, 32);
+BENCHMARK_TEMPLATE(BMT_StaticLexicographicIndexing_Decode, 64, 64, 64);
+BENCHMARK_TEMPLATE(BMT_StaticLexicographicIndexing_Decode, 33, 35, 37);
+BENCHMARK_TEMPLATE(BMT_StaticLexicographicIndexing_Decode, 100, 100, 100);
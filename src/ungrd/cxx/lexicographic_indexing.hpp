@@ -1,7 +1,11 @@
 #ifndef UNGRD_LEXICOGRAPHIC_INDEXING_HPP_6F86FA3F5DD1436DBB3EA110B6A5A6C5
 #define UNGRD_LEXICOGRAPHIC_INDEXING_HPP_6F86FA3F5DD1436DBB3EA110B6A5A6C5
 
+#include "fast_divisor.hpp"
+
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <optional>
 
 #include <cstddef>
@@ -36,25 +40,88 @@ public:
 
   // TODO: rename encode -> raw_encode, try_encode -> encode
 
+  // Does not divide: power of two extents are decoded with shifts and masks,
+  // other extents with a multiplication by a precomputed reciprocal.
   constexpr ndidx_type decode(index_type index) const {
     ndidx_type ndidx;
     if constexpr (ndim > 0) {
-      for (size_t dim = ndim - 1; dim >= 1; --dim) {
-        ndidx[dim] = index % extents_[dim];
-        index = index / extents_[dim];
+      if (power_of_two_extents_) {
+        for (size_t dim = 0; dim < ndim; ++dim)
+          ndidx[dim] = (index >> stride_shifts_[dim]) & (extents_[dim] - 1);
+      } else {
+        for (size_t dim = ndim - 1; dim >= 1; --dim) {
+          auto const quotient = extent_divisors_[dim].divide(index);
+          ndidx[dim] = index - quotient * extents_[dim];
+          index = quotient;
+        }
+        ndidx[0] = index;
       }
-      ndidx[0] = index;
     }
     return ndidx;
   }
 
   // TODO: rename decode -> raw_decode, ...
 
+public:
+  // Calls callback(ndidx, index, length) for every row of the box [lo, hi),
+  // i.e. for every run of length indices that are contiguous along the last
+  // dimension, in lexicographic order. The nd-index and the index of the first
+  // element of the row are advanced like an odometer, without any division.
+  template <typename FCallback>
+  constexpr void foreach_ndidx_row(
+      ndidx_type const &lo, ndidx_type const &hi, FCallback callback) const {
+    if constexpr (ndim > 0) {
+      for (size_t dim = 0; dim < ndim; ++dim)
+        if (lo[dim] >= hi[dim])
+          return;
+
+      ndidx_type ndidx = lo;
+      index_type index = encode(lo);
+      size_t const length = hi[ndim - 1] - lo[ndim - 1];
+
+      while (true) {
+        callback(static_cast<ndidx_type const &>(ndidx), index, length);
+
+        size_t dim = ndim - 1;
+        while (true) {
+          if (dim == 0)
+            return;
+          --dim;
+
+          ++ndidx[dim];
+          index += strides_[dim];
+          if (ndidx[dim] < hi[dim])
+            break;
+
+          ndidx[dim] = lo[dim];
+          index -= (hi[dim] - lo[dim]) * strides_[dim];
+        }
+      }
+    }
+  }
+
+  // Calls callback(ndidx, index) for every element of the box [lo, hi) in
+  // lexicographic order.
+  template <typename FCallback>
+  constexpr void foreach_ndidx(
+      ndidx_type const &lo, ndidx_type const &hi, FCallback callback) const {
+    foreach_ndidx_row(
+        lo, hi,
+        [&callback](ndidx_type ndidx, index_type const index, size_t length) {
+          for (size_t offset = 0; offset < length; ++offset) {
+            callback(static_cast<ndidx_type const &>(ndidx), index + offset);
+            ++ndidx[ndim - 1];
+          }
+        });
+  }
+
 public:
   constexpr auto const extents() const { return extents_; }
 
   constexpr size_t extent(size_t const dim) const { return extents_[dim]; }
 
+  constexpr size_t stride(size_t const dim) const { return strides_[dim]; }
+
   constexpr size_t const size() const { return size_; }
 
 private:
@@ -69,6 +136,14 @@ private:
         strides_[dim - 1] = extents_[dim] * strides_[dim];
       }
     }
+
+    power_of_two_extents_ = true;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      power_of_two_extents_ =
+          power_of_two_extents_ and std::has_single_bit(extents_[dim]);
+      stride_shifts_[dim] = std::countr_zero(strides_[dim]);
+      extent_divisors_[dim] = fast_divisor{std::max<size_t>(extents_[dim], 1)};
+    }
   }
 
 public:
@@ -83,6 +158,10 @@ private:
   std::array<size_t, ndim> extents_ = {};
   std::array<size_t, ndim> strides_ = {};
   size_t size_ = 0;
+
+  bool power_of_two_extents_ = false;
+  std::array<size_t, ndim> stride_shifts_ = {};
+  std::array<fast_divisor, ndim> extent_divisors_ = {};
 };
 
 } // namespace ungrd
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include "fast_divisor.hpp"
+#include "lexicographic_indexing.hpp"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+TEST(FastDivisor, Correctness) {
+  using namespace ungrd;
+
+  std::mt19937_64 gen{0};
+  std::uniform_int_distribution<std::uint64_t> dis;
+
+  constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+
+  for (std::uint64_t d :
+       {std::uint64_t{1}, std::uint64_t{2}, std::uint64_t{3}, std::uint64_t{7},
+        std::uint64_t{32}, std::uint64_t{100}, std::uint64_t{641},
+        (std::uint64_t{1} << 32) + 1, std::uint64_t{1} << 63,
+        (std::uint64_t{1} << 63) + 1, max - 1, max}) {
+    fast_divisor const divisor{d};
+    for (std::uint64_t n :
+         {std::uint64_t{0}, std::uint64_t{1}, d - 1, d, d + 1, max - 1, max}) {
+      ASSERT_EQ(n / d, divisor.divide(n)) << n << " / " << d;
+      ASSERT_EQ(n % d, divisor.modulo(n)) << n << " % " << d;
+    }
+    for (size_t round = 0; round < 1000; ++round) {
+      auto const n = dis(gen);
+      ASSERT_EQ(n / d, divisor.divide(n)) << n << " / " << d;
+    }
+  }
+
+  for (size_t round = 0; round < 10000; ++round) {
+    auto const d = std::max<std::uint64_t>(dis(gen) >> (round % 64), 1);
+    auto const n = dis(gen);
+    ASSERT_EQ(n / d, fast_divisor{d}.divide(n)) << n << " / " << d;
+  }
+}
+
+TEST(LexicographicIndexing, DecodeInvertsEncode) {
+  using namespace ungrd;
+  using indexing_type = lexicographic_indexing<3>;
+
+  for (auto const extents :
+       {indexing_type::ndidx_type{1, 1, 1}, indexing_type::ndidx_type{4, 8, 2},
+        indexing_type::ndidx_type{3, 5, 7}, indexing_type::ndidx_type{32, 1, 9},
+        indexing_type::ndidx_type{13, 16, 64}}) {
+    indexing_type const indexing{extents};
+    for (size_t index = 0; index < indexing.size(); ++index) {
+      auto const ndidx = indexing.decode(index);
+      ASSERT_EQ(index, indexing.encode(ndidx));
+
+      // reference decode using divisions
+      auto remainder = index;
+      for (size_t dim = 2; dim >= 1; --dim) {
+        ASSERT_EQ(remainder % extents[dim], ndidx[dim]);
+        remainder /= extents[dim];
+      }
+      ASSERT_EQ(remainder, ndidx[0]);
+    }
+  }
+}
+
+TEST(LexicographicIndexing, ForeachNdidx) {
+  using namespace ungrd;
+  using indexing_type = lexicographic_indexing<3>;
+  using ndidx_type = indexing_type::ndidx_type;
+
+  indexing_type const indexing{{5, 6, 7}};
+
+  ndidx_type const lo{1, 0, 2};
+  ndidx_type const hi{4, 6, 5};
+
+  std::vector<std::pair<ndidx_type, size_t>> visited;
+  indexing.foreach_ndidx(lo, hi, [&visited](auto const &ndidx, auto index) {
+    visited.emplace_back(ndidx, index);
+  });
+
+  std::vector<std::pair<ndidx_type, size_t>> expected;
+  for (size_t i = lo[0]; i < hi[0]; ++i)
+    for (size_t j = lo[1]; j < hi[1]; ++j)
+      for (size_t k = lo[2]; k < hi[2]; ++k)
+        expected.emplace_back(ndidx_type{i, j, k}, indexing.encode({i, j, k}));
+
+  ASSERT_EQ(expected, visited);
+
+  size_t row_count = 0;
+  indexing.foreach_ndidx_row(
+      lo, hi, [&](auto const &ndidx, auto index, auto length) {
+        ASSERT_EQ(lo[2], ndidx[2]);
+        ASSERT_EQ(indexing.encode(ndidx), index);
+        ASSERT_EQ(3, length);
+        ++row_count;
+      });
+  ASSERT_EQ(3 * 6, row_count);
+
+  // empty boxes do not call the callback
+  indexing.foreach_ndidx(
+      ndidx_type{1, 1, 1}, ndidx_type{2, 1, 2},
+      [](auto const &, auto) { FAIL(); });
+}
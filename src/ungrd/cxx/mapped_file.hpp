@@ -0,0 +1,129 @@
+#ifndef UNGRD_MAPPED_FILE_HPP_8828FC95923A4689A49D2A3A525355F5
+#define UNGRD_MAPPED_FILE_HPP_8828FC95923A4689A49D2A3A525355F5
+
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <cstddef>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#else
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <cstdint>
+#endif
+
+namespace ungrd {
+
+// A read-only view of the contents of a file. On Linux the file is mapped into
+// memory, its pages are only read from disk once they are accessed. Elsewhere
+// the file is read into memory. The bytes are aligned to at least 8 bytes.
+class mapped_file {
+public:
+  std::span<std::byte const> bytes() const { return {data_, size_}; }
+
+  std::size_t size() const { return size_; }
+
+#if defined(__linux__)
+public:
+  explicit mapped_file(std::string const &path) {
+    int const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      throw std::system_error{errno, std::generic_category(), path};
+
+    struct ::stat status;
+    if (::fstat(fd, &status) != 0) {
+      auto const error = errno;
+      ::close(fd);
+      throw std::system_error{error, std::generic_category(), path};
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ > 0) {
+      void *memory = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+      if (memory == MAP_FAILED) {
+        auto const error = errno;
+        ::close(fd);
+        throw std::system_error{error, std::generic_category(), path};
+      }
+      data_ = static_cast<std::byte const *>(memory);
+    }
+    ::close(fd);
+  }
+
+  ~mapped_file() {
+    if (data_ != nullptr)
+      ::munmap(const_cast<std::byte *>(data_), size_);
+  }
+
+  mapped_file(mapped_file &&other) noexcept
+      : data_{std::exchange(other.data_, nullptr)},
+        size_{std::exchange(other.size_, 0)} {}
+
+  mapped_file &operator=(mapped_file &&other) noexcept {
+    using std::swap;
+    swap(data_, other.data_);
+    swap(size_, other.size_);
+    return *this;
+  }
+
+  mapped_file(mapped_file const &) = delete;
+  mapped_file &operator=(mapped_file const &) = delete;
+
+private:
+  std::byte const *data_ = nullptr;
+  std::size_t size_ = 0;
+#else
+public:
+  explicit mapped_file(std::string const &path) {
+    std::ifstream in{path, std::ios::binary | std::ios::ate};
+    if (not in)
+      throw std::system_error{
+          std::make_error_code(std::errc::no_such_file_or_directory), path};
+
+    size_ = static_cast<std::size_t>(in.tellg());
+    buffer_.resize((size_ + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+    in.seekg(0);
+    in.read(reinterpret_cast<char *>(buffer_.data()), size_);
+    if (not in)
+      throw std::system_error{std::make_error_code(std::errc::io_error), path};
+
+    data_ = reinterpret_cast<std::byte const *>(buffer_.data());
+  }
+
+  mapped_file(mapped_file &&other) noexcept
+      : buffer_{std::move(other.buffer_)},
+        data_{std::exchange(other.data_, nullptr)},
+        size_{std::exchange(other.size_, 0)} {}
+
+  mapped_file &operator=(mapped_file &&other) noexcept {
+    using std::swap;
+    swap(buffer_, other.buffer_);
+    swap(data_, other.data_);
+    swap(size_, other.size_);
+    return *this;
+  }
+
+  mapped_file(mapped_file const &) = delete;
+  mapped_file &operator=(mapped_file const &) = delete;
+
+private:
+  std::vector<std::uint64_t> buffer_;
+  std::byte const *data_ = nullptr;
+  std::size_t size_ = 0;
+#endif
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_MAPPED_FILE_HPP_8828FC95923A4689A49D2A3A525355F5
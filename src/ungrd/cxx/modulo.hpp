@@ -8,7 +8,7 @@
 namespace ungrd {
 
 template <typename LHS, typename RHS>
-auto modulo(LHS lhs, RHS rhs) {
+constexpr auto modulo(LHS lhs, RHS rhs) {
   static_assert(std::is_integral<LHS>::value, "");
   static_assert(std::is_integral<RHS>::value, "");
   assert(rhs > 0);
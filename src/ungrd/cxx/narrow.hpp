@@ -0,0 +1,20 @@
+#ifndef UNGRD_NARROW_HPP_BF3C84D8E52041939BA92849DA969200
+#define UNGRD_NARROW_HPP_BF3C84D8E52041939BA92849DA969200
+
+#include "assert.hpp"
+
+#include <utility>
+
+namespace ungrd {
+
+// Converts the integer value to the integer type T and asserts that T can
+// represent it, which is only checked in debug builds.
+template <typename T, typename U>
+constexpr T narrow(U const value) {
+  UNGRD_ASSERT(value fits into the narrower type, std::in_range<T>(value));
+  return static_cast<T>(value);
+}
+
+} // namespace ungrd
+
+#endif // UNGRD_NARROW_HPP_BF3C84D8E52041939BA92849DA969200
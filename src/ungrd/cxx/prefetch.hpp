@@ -0,0 +1,24 @@
+#ifndef UNGRD_PREFETCH_HPP_C2A23CBB64E24E329C0374B2E81214AE
+#define UNGRD_PREFETCH_HPP_C2A23CBB64E24E329C0374B2E81214AE
+
+#if defined(_MSC_VER) and (defined(_M_X64) or defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace ungrd {
+
+// Hints that the cache line at address is read soon. Does nothing on compilers
+// without a prefetch intrinsic.
+inline void prefetch(void const *const address) {
+#if defined(__GNUC__) or defined(__clang__)
+  __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) and (defined(_M_X64) or defined(_M_IX86))
+  _mm_prefetch(static_cast<char const *>(address), _MM_HINT_T0);
+#else
+  (void) address;
+#endif
+}
+
+} // namespace ungrd
+
+#endif // UNGRD_PREFETCH_HPP_C2A23CBB64E24E329C0374B2E81214AE
@@ -2,6 +2,7 @@
 
 #include <bitset>
 
+#include "hierarchical_static_bitset.hpp"
 #include "static_bitset.hpp"
 
 #define GENERATE_BENCHMARKS(BM_)                                               \
@@ -10,7 +11,9 @@
   BENCHMARK_TEMPLATE(BM_, 64)->Range(1, 64);                                   \
   BENCHMARK_TEMPLATE(BM_, 128)->Range(1, 128);                                 \
   BENCHMARK_TEMPLATE(BM_, 256)->Range(1, 256);                                 \
-  BENCHMARK_TEMPLATE(BM_, 4096)->Range(1, 4096);
+  BENCHMARK_TEMPLATE(BM_, 4096)->Range(1, 4096);                               \
+  BENCHMARK_TEMPLATE(BM_, 16384)->Range(1, 16384);                             \
+  BENCHMARK_TEMPLATE(BM_, 65536)->Range(1, 65536);
 
 // Any_FirstBitSet
 
@@ -40,6 +43,52 @@ static void BM_StaticBitset_Any_OneBitSet(benchmark::State &state) {
 }
 GENERATE_BENCHMARKS(BM_StaticBitset_Any_OneBitSet)
 
+template <size_t NBits>
+static void BM_HierarchicalStaticBitset_Any_OneBitSet(benchmark::State &state) {
+  ungrd::hierarchical_static_bitset<NBits, unsigned int> bits;
+
+  bits.set(state.range(0) - 1);
+
+  for (auto _ : state) {
+    for (size_t count = 0; count < 1000; ++count)
+      benchmark::DoNotOptimize(bits.any());
+  }
+}
+GENERATE_BENCHMARKS(BM_HierarchicalStaticBitset_Any_OneBitSet)
+
+// CountrOne_FirstBitsSet
+
+template <size_t NBits>
+static void BM_StaticBitset_CountrOne_FirstBitsSet(benchmark::State &state) {
+  ungrd::static_bitset<NBits> bits;
+
+  auto const size = static_cast<size_t>(state.range(0));
+  for (size_t index = 0; index + 1 < size; ++index)
+    bits.set(index);
+
+  for (auto _ : state) {
+    for (size_t count = 0; count < 1000; ++count)
+      benchmark::DoNotOptimize(bits.countr_one());
+  }
+}
+GENERATE_BENCHMARKS(BM_StaticBitset_CountrOne_FirstBitsSet)
+
+template <size_t NBits>
+static void
+BM_HierarchicalStaticBitset_CountrOne_FirstBitsSet(benchmark::State &state) {
+  ungrd::hierarchical_static_bitset<NBits> bits;
+
+  auto const size = static_cast<size_t>(state.range(0));
+  for (size_t index = 0; index + 1 < size; ++index)
+    bits.set(index);
+
+  for (auto _ : state) {
+    for (size_t count = 0; count < 1000; ++count)
+      benchmark::DoNotOptimize(bits.countr_one());
+  }
+}
+GENERATE_BENCHMARKS(BM_HierarchicalStaticBitset_CountrOne_FirstBitsSet)
+
 // SetAndGet
 
 template <size_t NBits>
@@ -67,3 +116,17 @@ static void BM_StaticBitset_SetAndGet(benchmark::State &state) {
   }
 }
 GENERATE_BENCHMARKS(BM_StaticBitset_SetAndGet)
+
+template <size_t NBits>
+static void BM_HierarchicalStaticBitset_SetAndGet(benchmark::State &state) {
+  ungrd::hierarchical_static_bitset<NBits, unsigned int> bits;
+
+  auto const size = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    for (size_t index = 0; index < size; ++index) {
+      bits.set(0);
+      benchmark::DoNotOptimize(bits.get(0));
+    }
+  }
+}
+GENERATE_BENCHMARKS(BM_HierarchicalStaticBitset_SetAndGet)
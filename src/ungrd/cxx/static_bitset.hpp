@@ -14,8 +14,10 @@ namespace ungrd {
 
 template <size_t NBits, std::unsigned_integral TChunk = size_t>
 class static_bitset {
+public:
   using chunk_type = TChunk;
 
+private:
   static constexpr size_t chunk_bits = sizeof(chunk_type) * 8;
   static constexpr size_t chunk_count = (NBits / chunk_bits) + 1;
 
@@ -146,6 +148,28 @@ public:
     return std::min(result, NBits);
   }
 
+public:
+  static constexpr size_t count_chunks() { return chunk_count; }
+
+  static constexpr size_t bits_per_chunk() { return chunk_bits; }
+
+  // mask of the bits in the chunk that belong to the bitset
+  static constexpr chunk_type get_chunk_mask_of_valid_bits(
+      size_t const chunk_index) {
+    assert(chunk_index < chunk_count);
+    return chunk_index + 1 < chunk_count ? chunk_all_set : last_chunk_mask;
+  }
+
+  constexpr chunk_type get_chunk(size_t const chunk_index) const {
+    assert(chunk_index < chunk_count);
+    return chunks_[chunk_index];
+  }
+
+  constexpr void set_chunk(size_t const chunk_index, chunk_type const chunk) {
+    assert(chunk_index < chunk_count);
+    chunks_[chunk_index] = chunk;
+  }
+
 private:
   std::array<chunk_type, chunk_count> chunks_ = {};
 };
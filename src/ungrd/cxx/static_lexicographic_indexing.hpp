@@ -0,0 +1,123 @@
+#ifndef UNGRD_STATIC_LEXICOGRAPHIC_INDEXING_HPP_B39CAC20E3D7442C87CE524DEB51FE17
+#define UNGRD_STATIC_LEXICOGRAPHIC_INDEXING_HPP_B39CAC20E3D7442C87CE524DEB51FE17
+
+#include <array>
+#include <optional>
+#include <utility>
+
+#include <cstddef>
+
+namespace ungrd {
+
+// Counterpart of lexicographic_indexing with extents known at compile time.
+// Extents and strides are constant expressions and every per-dimension loop is
+// a fold expression, so encode and decode unroll into multiplications, shifts
+// and masks by constants.
+template <size_t... NExtents>
+class static_lexicographic_indexing {
+public:
+  static constexpr size_t ndim = sizeof...(NExtents);
+
+  using index_type = size_t;
+  using ndidx_type = std::array<size_t, ndim>;
+
+  static_assert(((NExtents > 0) and ...));
+
+private:
+  static constexpr ndidx_type extents_ = {NExtents...};
+
+  static constexpr ndidx_type strides_ = [] {
+    ndidx_type strides = {};
+    if constexpr (ndim > 0) {
+      strides[ndim - 1] = 1;
+      for (size_t dim = ndim - 1; dim >= 1; --dim)
+        strides[dim - 1] = extents_[dim] * strides[dim];
+    }
+    return strides;
+  }();
+
+  static constexpr size_t size_ = (size_t{1} * ... * NExtents);
+
+  using dims = std::make_index_sequence<ndim>;
+
+public:
+  static constexpr index_type encode(ndidx_type const &ndidx) {
+    return [&ndidx]<size_t... Dims>(std::index_sequence<Dims...>) {
+      return (index_type{0} + ... + (ndidx[Dims] * strides_[Dims]));
+    }(dims{});
+  }
+
+  // One unsigned compare per dimension, negative indices wrap around to large
+  // values and fail the same compare.
+  static constexpr bool contains(ndidx_type const &ndidx) {
+    return [&ndidx]<size_t... Dims>(std::index_sequence<Dims...>) {
+      return (true & ... & (ndidx[Dims] < extents_[Dims]));
+    }(dims{});
+  }
+
+  static constexpr std::optional<index_type> try_encode(
+      ndidx_type const &ndidx) {
+    if (not contains(ndidx))
+      return std::nullopt;
+    return encode(ndidx);
+  }
+
+  static constexpr ndidx_type decode(index_type const index) {
+    ndidx_type ndidx;
+    [&ndidx, index]<size_t... Dims>(std::index_sequence<Dims...>) {
+      ((ndidx[Dims] = Dims == 0 ? index / strides_[Dims]
+                                : index / strides_[Dims] % extents_[Dims]),
+       ...);
+    }(dims{});
+    return ndidx;
+  }
+
+public:
+  // Calls callback(ndidx, index, length) for every row of the box [lo, hi), see
+  // lexicographic_indexing::foreach_ndidx_row.
+  template <typename FCallback>
+  static constexpr void foreach_ndidx_row(
+      ndidx_type const &lo, ndidx_type const &hi, FCallback callback) {
+    if constexpr (ndim > 0) {
+      for (size_t dim = 0; dim < ndim; ++dim)
+        if (lo[dim] >= hi[dim])
+          return;
+
+      ndidx_type ndidx = lo;
+      index_type index = encode(lo);
+      size_t const length = hi[ndim - 1] - lo[ndim - 1];
+
+      while (true) {
+        callback(static_cast<ndidx_type const &>(ndidx), index, length);
+
+        size_t dim = ndim - 1;
+        while (true) {
+          if (dim == 0)
+            return;
+          --dim;
+
+          ++ndidx[dim];
+          index += strides_[dim];
+          if (ndidx[dim] < hi[dim])
+            break;
+
+          ndidx[dim] = lo[dim];
+          index -= (hi[dim] - lo[dim]) * strides_[dim];
+        }
+      }
+    }
+  }
+
+public:
+  static constexpr auto extents() { return extents_; }
+
+  static constexpr size_t extent(size_t const dim) { return extents_[dim]; }
+
+  static constexpr size_t stride(size_t const dim) { return strides_[dim]; }
+
+  static constexpr size_t size() { return size_; }
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_STATIC_LEXICOGRAPHIC_INDEXING_HPP_B39CAC20E3D7442C87CE524DEB51FE17
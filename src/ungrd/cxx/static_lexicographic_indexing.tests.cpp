@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "lexicographic_indexing.hpp"
+#include "static_lexicographic_indexing.hpp"
+
+TEST(StaticLexicographicIndexing, MatchesLexicographicIndexing) {
+  using namespace ungrd;
+
+  auto const check = []<size_t... NExtents>() {
+    using static_indexing_type = static_lexicographic_indexing<NExtents...>;
+    lexicographic_indexing<sizeof...(NExtents)> const indexing{{NExtents...}};
+
+    ASSERT_EQ(indexing.size(), static_indexing_type::size());
+    ASSERT_EQ(indexing.extents(), static_indexing_type::extents());
+
+    for (size_t index = 0; index < indexing.size(); ++index) {
+      auto const ndidx = static_indexing_type::decode(index);
+      ASSERT_EQ(indexing.decode(index), ndidx);
+      ASSERT_EQ(index, static_indexing_type::encode(ndidx));
+      ASSERT_EQ(index, static_indexing_type::try_encode(ndidx));
+    }
+  };
+
+  check.template operator()<1, 1, 1>();
+  check.template operator()<4, 8, 2>();
+  check.template operator()<3, 5, 7>();
+  check.template operator()<13, 16, 64>();
+}
+
+TEST(StaticLexicographicIndexing, Contains) {
+  using namespace ungrd;
+  using indexing_type = static_lexicographic_indexing<4, 5, 6>;
+  using ndidx_type = indexing_type::ndidx_type;
+
+  static_assert(indexing_type::size() == 4 * 5 * 6);
+  static_assert(indexing_type::encode({1, 2, 3}) == 1 * 30 + 2 * 6 + 3);
+  static_assert(
+      indexing_type::decode(1 * 30 + 2 * 6 + 3) == ndidx_type{1, 2, 3});
+
+  ASSERT_TRUE(indexing_type::contains({0, 0, 0}));
+  ASSERT_TRUE(indexing_type::contains({3, 4, 5}));
+  ASSERT_FALSE(indexing_type::contains({4, 0, 0}));
+  ASSERT_FALSE(indexing_type::contains({0, 5, 0}));
+  ASSERT_FALSE(indexing_type::contains({0, 0, 6}));
+
+  // negative indices wrap around
+  ASSERT_FALSE(indexing_type::contains({0, static_cast<size_t>(-1), 0}));
+  ASSERT_FALSE(indexing_type::try_encode({0, 0, static_cast<size_t>(-1)}));
+}
@@ -36,6 +36,14 @@ BENCHMARK_TEMPLATE(BMT_Grid_SomeMoveOneUpdate_RandomCells, s32_e32_dense_grid<3>
         {EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE,
          RANDOM_ENTRY_RANGE});
 
+// SomeMoveOneTrackedUpdate
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_SomeMoveOneTrackedUpdate_RandomCells, s32_e32_dense_grid<3>)
+    ->Ranges(
+        {EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE,
+         MOVE_COUNT_RANGE});
+
 // CountAllEntries
 
 BENCHMARK_TEMPLATE(BMT_Grid_CountAllEntries_DenseCells, s32_e32_dense_grid<3>)
@@ -43,3 +51,41 @@ BENCHMARK_TEMPLATE(BMT_Grid_CountAllEntries_DenseCells, s32_e32_dense_grid<3>)
 
 BENCHMARK_TEMPLATE(BMT_Grid_CountAllEntries_RandomCells, s32_e32_dense_grid<3>)
     ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+// CountEntriesInBox
+
+BENCHMARK_TEMPLATE(BMT_Grid_CountEntriesInBox_RandomCells, s32_e32_dense_grid<3>)
+    ->Ranges(
+        {EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE,
+         BOX_SIDE_RANGE});
+
+// RaysThroughCells
+
+BENCHMARK_TEMPLATE(BMT_Grid_RaysThroughCells_RandomCells, s32_e32_dense_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_RayBatchThroughCells_RandomCells, s32_e32_dense_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+// 16-bit positions and entries
+
+BENCHMARK_TEMPLATE(BMT_Grid_FirstUpdate_DenseCells, s32_e32_dense_grid<3>)
+    ->Ranges(
+        {NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE,
+         NARROW_DENSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(BMT_Grid_FirstUpdate_DenseCells, s16_e16_dense_grid<3>)
+    ->Ranges(
+        {NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE,
+         NARROW_DENSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(BMT_Grid_CountAllEntries_DenseCells, s32_e32_dense_grid<3>)
+    ->Ranges(
+        {NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE,
+         NARROW_DENSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(BMT_Grid_CountAllEntries_DenseCells, s16_e16_dense_grid<3>)
+    ->Ranges(
+        {NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE, NARROW_EXTENT_RANGE,
+         NARROW_DENSE_ENTRY_RANGE});
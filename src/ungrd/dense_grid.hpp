@@ -1,16 +1,27 @@
 #ifndef UNGRD_DENSE_GRID_HPP_68F5A7B39EA04EF4A38B5422B2E0A742
 #define UNGRD_DENSE_GRID_HPP_68F5A7B39EA04EF4A38B5422B2E0A742
 
+#include "cxx/assert.hpp"
+#include "cxx/dynamic_bitset.hpp"
 #include "cxx/lexicographic_indexing.hpp"
 #include "cxx/map.hpp"
 
+#include "entry_cell.hpp"
 #include "entry_policy.hpp"
+#include "entry_tracker.hpp"
+#include "grid_stats.hpp"
+#include "ray_traversal.hpp"
 #include "object_pool.hpp"
 #include "space_policy.hpp"
 
 #include <algorithm>
 #include <array>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <optional>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -18,75 +29,71 @@
 
 namespace ungrd {
 
-template <typename PSpace, typename PEntry>
+template <
+    typename PSpace, typename PEntry,
+    typename TAllocator = std::allocator<typename PEntry::entry>>
 class dense_grid {
 public:
   using space_policy = PSpace;
   using entry_policy = PEntry;
+  using allocator_type = TAllocator;
 
 private:
   static constexpr std::size_t ndim = space_policy::ndim;
   using position_type = typename space_policy::position;
+  using position_index_type = typename position_type::value_type;
+  using unsigned_position_index_type =
+      std::make_unsigned_t<position_index_type>;
   using position_hash = boost::hash<position_type>;
 
   using entry_type = typename entry_policy::entry;
 
+  static_assert(
+      not is_packed_entry_policy<entry_policy>,
+      "only compact_grid supports packed cells");
+
   using indexing_type = lexicographic_indexing<ndim>;
   using ndidx_type = typename indexing_type::ndidx_type;
 
-  using entry_vector = std::vector<entry_type>;
-
 private:
   using cidx_type = std::size_t;
 
-  class cell_type {
-  public:
-    bool empty() const { return entries_.empty(); }
-
-    auto const &entries() const { return entries_; }
-
-    void reserve_entries(size_t count) { entries_.reserve(count); }
-
-    void add_entry(entry_type entry) {
-      using std::begin, std::end;
-      auto it = std::find(begin(entries_), end(entries_), entry);
-      if (it == end(entries_))
-        entries_.emplace_back(entry);
-    }
+  using cell_type = entry_cell<entry_policy, allocator_type>;
 
-    void erase_entry(entry_type entry) {
-      using std::begin, std::end;
-      auto it = std::find(begin(entries_), end(entries_), entry);
-      if (it != end(entries_))
-        entries_.erase(it);
-    }
+  using tracker_type = entry_tracker<position_type, entry_type>;
 
-    friend void swap(cell_type &a, cell_type &b) {
-      using std::swap;
-      swap(a.entries_, b.entries_);
-    }
+public:
+  size_t count_filled_cells() const { return stats_.filled_cells; }
 
-  public:
-    cell_type() = default;
+  grid_stats<position_type> stats() const {
+    auto stats = stats_;
+    std::tie(stats.lo, stats.hi) = bounding_box();
+    return stats;
+  }
 
-  private:
-    entry_vector entries_ = {};
-  };
+  // the inclusive box of the stored cells, it contains all filled cells
+  std::pair<position_type, position_type> bounding_box() const {
+    if (indexing_.size() == 0)
+      return {
+          space_policy::most_positive_position(),
+          space_policy::most_negative_position()};
 
-public:
-  size_t count_filled_cells() const {
-    size_t count = 0;
-    for (auto const &cell : cidx_to_cell_) {
-      count += not cell.empty();
+    position_type lo, hi;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      lo[dim] = -offsets_[dim];
+      hi[dim] = lo[dim] + static_cast<position_index_type>(
+                              indexing_.extent(dim) - 1);
     }
-    return count;
+    return {lo, hi};
   }
 
 public:
   template <typename FCallback>
   void foreach_entry_at_position(
       position_type const &cpos, FCallback callback) const {
-    if (auto const ndidx = try_cpos_to_ndidx(cpos, offsets_, indexing_)) {
+    auto const wrapped_cpos = space_policy::wrap(cpos);
+    if (auto const ndidx =
+            try_cpos_to_ndidx(wrapped_cpos, offsets_, indexing_)) {
       auto const cidx = indexing_.encode(*ndidx);
       auto const &cell = cidx_to_cell_[cidx];
       if (not cell.empty())
@@ -95,35 +102,89 @@ public:
     }
   }
 
+  // Calls callback(entry) for every entry in the cells of the box [lo, hi].
   template <typename FCallback>
-  void foreach_position(FCallback callback) const {
-    for (size_t cidx = 0; cidx < cidx_to_cell_.size(); ++cidx) {
-      if (not cidx_to_cell_[cidx].empty()) {
-        auto const ndidx = indexing_.decode(cidx);
-        auto const cpos = ndidx_to_cpos(ndidx);
+  void foreach_entry_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    foreach_cell_in_box(lo, hi, [&callback](auto const &view) {
+      for (auto const entry : view.entries)
+        callback(entry);
+    });
+  }
 
-        callback(cpos);
-      }
+  // Calls callback(view) with an entry_cell_view of every filled cell in the
+  // box [lo, hi]. The box is clipped to the stored cells, which are scanned row
+  // by row. In periodic spaces the box wraps around the faces of the domain.
+  template <typename FCallback>
+  void foreach_cell_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    space_policy::foreach_wrapped_box(
+        lo, hi,
+        [this, &callback](
+            position_type const &box_lo, position_type const &box_hi) {
+          foreach_cell_in_stored_box(box_lo, box_hi, callback);
+        });
+  }
+
+  // Calls callback(cpos, t_enter, t_exit, entries) for every filled cell that
+  // the segment origin + t * direction, t in [0, t_max], passes through, in
+  // order. Coordinates are in units of the cell size, the traversal stops when
+  // the callback returns false. Steps between cells by adding strides to the
+  // cell index. Rays do not wrap around the faces of periodic spaces.
+  template <typename TReal, typename FCallback>
+  void foreach_cell_along_ray(
+      std::array<TReal, ndim> const &origin,
+      std::array<TReal, ndim> const &direction,
+      std::type_identity_t<TReal> const t_max, FCallback callback) const {
+    auto const [lo, hi] = bounding_box();
+    ray_traversal<position_type, TReal> ray{origin, direction, t_max, lo, hi};
+    if (not ray.valid())
+      return;
+
+    auto cidx = indexing_.encode(cpos_to_ndidx(ray.cpos()));
+    while (true) {
+      if (filled_cells_.get(cidx) and
+          not callback(
+              ray.cpos(), ray.t_enter(), ray.t_exit(),
+              cidx_to_cell_[cidx].entries()))
+        return;
+
+      if (not ray.step())
+        return;
+
+      auto const stride = indexing_.stride(ray.step_dim());
+      if (ray.step_sign() > 0)
+        cidx += stride;
+      else
+        cidx -= stride;
     }
   }
 
+  template <typename FCallback>
+  void foreach_position(FCallback callback) const {
+    filled_cells_.foreach_set_bit([this, &callback](cidx_type const cidx) {
+      auto const ndidx = indexing_.decode(cidx);
+      auto const cpos = ndidx_to_cpos(ndidx);
+
+      callback(cpos);
+    });
+  }
+
 public:
   template <typename TInput>
   void update(TInput const &input) {
+    if (tracker_)
+      tracker_->invalidate();
+
     position_type lo = space_policy::most_positive_position();
     position_type hi = space_policy::most_negative_position();
 
-    auto &map = update_map_;
-    map.clear();
-
-    for (auto const [cpos, entry] : input) {
-      auto [it, inserted] = map.try_emplace(cpos);
-
-      auto &cell = it->second;
-      if (inserted)
-        cell.reserve_entries(50);
-
-      cell.add_entry(entry);
+    bool empty = true;
+    for (auto const &element : input) {
+      auto const cpos = space_policy::wrap(std::get<0>(element));
+      empty = false;
 
       // update lo and hi cell positions
       for (size_t dim = 0; dim < ndim; ++dim) {
@@ -132,64 +193,105 @@ public:
       }
     }
 
-    if (map.size() == 0) {
+    // none of the entries of the previous update are kept, but their cells
+    // are refilled
+    clear_filled_cells();
+
+    if (empty) {
       offsets_.fill(0);
-    } else {
-      position_type offsets;
-      ndidx_type extents;
-      for (size_t dim = 0; dim < ndim; ++dim) {
-        offsets[dim] = -lo[dim];
-        extents[dim] = hi[dim] - lo[dim] + 1;
-      }
+      return;
+    }
 
-      reshape(offsets, extents);
+    auto const [offsets, extents] = stored_box_shape(lo, hi);
+    reindex(offsets, extents);
 
-      for (auto &[cpos, cell] : map) {
-        auto const ndidx = cpos_to_ndidx(cpos);
-        auto const cidx = indexing_.encode(ndidx);
+    for (auto const &element : input) {
+      auto const cpos = space_policy::wrap(std::get<0>(element));
+      auto const cidx = indexing_.encode(cpos_to_ndidx(cpos));
 
-        using std::swap;
-        swap(cidx_to_cell_[cidx], cell);
-      }
+      auto &cell = cidx_to_cell_[cidx];
+      auto const old_size = cell.size();
+      if (old_size == 0)
+        cell.reserve_entries(50);
+
+      cell.add_input_entry(element);
+      filled_cells_.set(cidx);
+      stats_.resize_cell(old_size, cell.size());
     }
   }
 
 public:
+  // Updates the grid with the positions of all entries, cposes[entry] is the
+  // cell position of entry. The grid remembers the position of every entry and
+  // only moves the entries whose cell changed. Calling update or
+  // differential_update in between makes the next call rebuild the grid.
+  template <typename TPositions>
+  void tracked_update(TPositions const &cposes)
+    requires std::is_void_v<typename entry_policy::payload>
+  {
+    if (not tracker_)
+      tracker_ = std::make_unique<tracker_type>();
+
+    auto &tracker = *tracker_;
+    if (tracker.track(cposes))
+      differential_update(tracker.fresh(), tracker.stale());
+    else
+      update(tracker.fresh());
+    tracker.validate();
+  }
+
   template <typename TFresh, typename TStale>
   void differential_update(TFresh const &fresh, TStale const &stale) {
+    if (tracker_)
+      tracker_->invalidate();
+
     // remove stale entries from their cells
-    for (auto const &[cpos, entry] : stale) {
-      auto const ndidx = cpos_to_ndidx(cpos);
+    for (auto const &element : stale) {
+      auto const ndidx =
+          cpos_to_ndidx(space_policy::wrap(std::get<0>(element)));
       auto const cidx = indexing_.encode(ndidx);
 
-      cidx_to_cell_[cidx].erase_entry(entry);
+      auto &cell = cidx_to_cell_[cidx];
+      auto const old_size = cell.size();
+      cell.erase_entry(std::get<1>(element));
+      stats_.resize_cell(old_size, cell.size());
+      if (cell.empty())
+        filled_cells_.reset(cidx);
     }
 
-    // initialize lo and hi cell positions
-    position_type lo = offsets_;
-    position_type hi;
-    for (size_t dim = 0; dim < ndim; ++dim) {
-      hi[dim] = offsets_[dim] + indexing_.extent(dim);
+    // initialize lo and hi cell positions to the currently stored cells
+    position_type lo = space_policy::most_positive_position();
+    position_type hi = space_policy::most_negative_position();
+    if (indexing_.size() > 0) {
+      for (size_t dim = 0; dim < ndim; ++dim) {
+        lo[dim] = -offsets_[dim];
+        hi[dim] = -offsets_[dim] + indexing_.extent(dim) - 1;
+      }
     }
 
     auto &map = update_map_;
     map.clear();
 
-    for (auto const &[cpos, entry] : fresh) {
+    for (auto const &element : fresh) {
+      auto const cpos = space_policy::wrap(std::get<0>(element));
       auto const ndidx = cpos_to_ndidx(cpos);
 
       if (auto const cidx = indexing_.try_encode(ndidx)) {
         // known cell, just add the entry
-        cidx_to_cell_[*cidx].add_entry(entry);
+        auto &cell = cidx_to_cell_[*cidx];
+        auto const old_size = cell.size();
+        cell.add_input_entry(element);
+        stats_.resize_cell(old_size, cell.size());
+        filled_cells_.set(*cidx);
       } else {
         // try to add a new cell to the temporary map
-        auto [it, inserted] = map.try_emplace(cpos);
+        auto [it, inserted] = map.try_emplace(cpos, allocator_);
 
         auto &cell = it->second;
         if (inserted)
           cell.reserve_entries(50);
 
-        cell.add_entry(entry);
+        cell.add_input_entry(element);
 
         // update lo and hi cell positions
         for (size_t dim = 0; dim < ndim; ++dim) {
@@ -200,16 +302,8 @@ public:
     }
 
     if (map.size() > 0) {
-      { // compute the new offsets and extents and reshape the array
-        position_type new_offsets;
-        ndidx_type new_extents;
-        for (size_t dim = 0; dim < ndim; ++dim) {
-          new_offsets[dim] = -lo[dim];
-          new_extents[dim] = hi[dim] - lo[dim] + 1;
-        }
-
-        reshape(new_offsets, new_extents);
-      }
+      auto const [new_offsets, new_extents] = stored_box_shape(lo, hi);
+      reshape(new_offsets, new_extents);
 
       // consume the new cells
       for (auto &[cpos, cell] : map) {
@@ -218,11 +312,51 @@ public:
 
         using std::swap;
         swap(cidx_to_cell_[cidx], cell);
+        filled_cells_.set(cidx);
+        stats_.resize_cell(0, cidx_to_cell_[cidx].size());
       }
     }
   }
 
 private:
+  // The offsets and extents of the stored box [lo, hi]. Indices into the box
+  // are computed with position_index_type, debug builds check that it can
+  // count the cells of the box in every dimension.
+  static std::pair<position_type, ndidx_type>
+  stored_box_shape(position_type const &lo, position_type const &hi) {
+    using limits = std::numeric_limits<position_index_type>;
+
+    position_type offsets;
+    ndidx_type extents;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      auto const span = static_cast<unsigned_position_index_type>(
+          static_cast<unsigned_position_index_type>(hi[dim]) -
+          static_cast<unsigned_position_index_type>(lo[dim]));
+      UNGRD_ASSERT(
+          cell positions span less than the largest position index,
+          lo[dim] > limits::lowest() and span < size_t(limits::max()));
+
+      offsets[dim] = static_cast<position_index_type>(-lo[dim]);
+      extents[dim] = size_t(span) + 1;
+    }
+    return {offsets, extents};
+  }
+
+  // Changes the stored box like reshape, but does not move any cells, all
+  // cells must be empty. The cells are reused for the new box and are only
+  // ever added, a smaller box keeps the cells past its end for later updates.
+  void
+  reindex(position_type const &new_offsets, ndidx_type const &new_extents) {
+    UNGRD_ASSERT(all cells must be empty, filled_cells_.none());
+
+    offsets_ = new_offsets;
+    indexing_ = indexing_type{new_extents};
+
+    if (cidx_to_cell_.size() < indexing_.size())
+      resize_cells(cidx_to_cell_, indexing_.size(), allocator_);
+    filled_cells_.resize(indexing_.size());
+  }
+
   void
   reshape(position_type const &new_offsets, ndidx_type const &new_extents) {
     using std::swap;
@@ -230,23 +364,95 @@ private:
     auto const &old_indexing = indexing_;
     indexing_type new_indexing{new_extents};
 
-    std::vector<cell_type> new_cidx_to_cell;
-    new_cidx_to_cell.resize(new_indexing.size());
+    auto new_cidx_to_cell =
+        make_cells<cell_type>(new_indexing.size(), allocator_);
 
-    for (size_t old_cidx = 0; old_cidx < old_indexing.size(); ++old_cidx) {
-      auto const old_ndidx = old_indexing.decode(old_cidx);
-      auto const cpos = ndidx_to_cpos(old_ndidx);
+    dynamic_bitset<> new_filled_cells{new_indexing.size()};
 
-      if (auto new_ndidx = try_cpos_to_ndidx(cpos, new_offsets, new_indexing)) {
-        auto const new_cidx = new_indexing.encode(*new_ndidx);
-
-        swap(new_cidx_to_cell[new_cidx], cidx_to_cell_[old_cidx]);
-      }
+    // the overlap of the old and new cells as old nd-indices
+    ndidx_type old_lo, old_hi, old_to_new;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      auto const old_extent =
+          static_cast<position_index_type>(old_indexing.extent(dim));
+      auto const new_extent =
+          static_cast<position_index_type>(new_indexing.extent(dim));
+
+      auto const lo = std::max(-offsets_[dim], -new_offsets[dim]);
+      auto const hi = std::min(
+          -offsets_[dim] + old_extent, -new_offsets[dim] + new_extent);
+      old_lo[dim] = lo + offsets_[dim];
+      old_hi[dim] = std::max(lo, hi) + offsets_[dim];
+      old_to_new[dim] = new_offsets[dim] - offsets_[dim];
     }
 
+    // move the overlap row by row
+    old_indexing.foreach_ndidx_row(
+        old_lo, old_hi,
+        [&](ndidx_type const &old_ndidx, cidx_type const old_cidx,
+            size_t const length) {
+          ndidx_type new_ndidx;
+          for (size_t dim = 0; dim < ndim; ++dim)
+            new_ndidx[dim] = old_ndidx[dim] + old_to_new[dim];
+          auto const new_cidx = new_indexing.encode(new_ndidx);
+
+          std::swap_ranges(
+              cidx_to_cell_.begin() + old_cidx,
+              cidx_to_cell_.begin() + old_cidx + length,
+              new_cidx_to_cell.begin() + new_cidx);
+
+          filled_cells_.foreach_set_bit_in_range(
+              old_cidx, old_cidx + length, [&](cidx_type const cidx) {
+                new_filled_cells.set(cidx - old_cidx + new_cidx);
+              });
+        });
+
     offsets_ = new_offsets;
     indexing_ = new_indexing;
     swap(cidx_to_cell_, new_cidx_to_cell);
+    swap(filled_cells_, new_filled_cells);
+  }
+
+  // foreach_cell_in_box without wrapping the box
+  template <typename FCallback>
+  void foreach_cell_in_stored_box(
+      position_type const &lo, position_type const &hi,
+      FCallback &callback) const {
+    if (indexing_.size() == 0)
+      return;
+
+    ndidx_type ndidx_lo, ndidx_hi;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      // the stored positions fit into position_index_type
+      auto const stored_lo = static_cast<position_index_type>(-offsets_[dim]);
+      auto const stored_hi = static_cast<position_index_type>(
+          stored_lo + static_cast<position_index_type>(indexing_.extent(dim)) -
+          1);
+      auto const first = std::max(lo[dim], stored_lo);
+      auto const last = std::min(hi[dim], stored_hi);
+      if (first > last)
+        return;
+
+      ndidx_lo[dim] = first + offsets_[dim];
+      ndidx_hi[dim] = last + offsets_[dim] + 1;
+    }
+
+    indexing_.foreach_ndidx_row(
+        ndidx_lo, ndidx_hi,
+        [this, &callback](
+            ndidx_type const &, cidx_type const first, size_t const length) {
+          filled_cells_.foreach_set_bit_in_range(
+              first, first + length, [this, &callback](cidx_type const cidx) {
+                callback(cidx_to_cell_[cidx].view());
+              });
+        });
+  }
+
+  void clear_filled_cells() {
+    filled_cells_.foreach_set_bit([this](cidx_type const cidx) {
+      cidx_to_cell_[cidx].clear_entries();
+    });
+    filled_cells_.reset_all();
+    stats_.clear();
   }
 
 private:
@@ -290,24 +496,76 @@ private:
     return ndidx_to_cpos(ndidx, offsets_);
   }
 
+public:
+  allocator_type get_allocator() const { return allocator_; }
+
+  // Drops all cells and frees their memory.
+  void clear() { *this = dense_grid{allocator_}; }
+
 public:
   dense_grid() = default;
+  explicit dense_grid(allocator_type const &allocator)
+      : allocator_{allocator} {}
   dense_grid(dense_grid const &) = delete;
   dense_grid &operator=(dense_grid const &) = delete;
   dense_grid(dense_grid &&) = default;
-  dense_grid &operator=(dense_grid &&) = default;
+
+  // Moves the cells of other into memory from allocator and leaves other
+  // empty.
+  dense_grid(dense_grid &&other, allocator_type const &allocator)
+      : allocator_{allocator}, offsets_{other.offsets_},
+        indexing_{other.indexing_},
+        cidx_to_cell_{move_cells(std::move(other.cidx_to_cell_), allocator)},
+        filled_cells_{std::move(other.filled_cells_)},
+        stats_{std::move(other.stats_)}, tracker_{std::move(other.tracker_)} {
+    other.clear();
+  }
+
+  // Swaps the contents if the allocators compare equal, otherwise moves the
+  // cells.
+  dense_grid &operator=(dense_grid &&other) noexcept(
+      std::allocator_traits<allocator_type>::is_always_equal::value) {
+    if (not(allocator_ == other.allocator_))
+      return *this = dense_grid{std::move(other), allocator_};
+
+    using std::swap;
+    swap(offsets_, other.offsets_);
+    swap(indexing_, other.indexing_);
+    swap(cidx_to_cell_, other.cidx_to_cell_);
+    swap(filled_cells_, other.filled_cells_);
+    swap(update_map_, other.update_map_);
+    swap(stats_, other.stats_);
+    swap(tracker_, other.tracker_);
+    return *this;
+  }
 
 private:
-  position_type offsets_;
+  allocator_type allocator_ = {};
+
+  position_type offsets_ = {};
   indexing_type indexing_;
 
   std::vector<cell_type> cidx_to_cell_;
+  dynamic_bitset<> filled_cells_;
   hash_map<position_type, cell_type, position_hash> update_map_;
+
+  grid_stats<position_type> stats_ = {};
+
+  // allocated by the first tracked_update
+  std::unique_ptr<tracker_type> tracker_ = {};
 };
 
 template <size_t NDim>
 using s32_e32_dense_grid = dense_grid<s32_space_policy<NDim>, u32_entry_policy>;
 
+template <size_t NDim>
+using s16_e16_dense_grid = dense_grid<s16_space_policy<NDim>, u16_entry_policy>;
+
+template <size_t NDim>
+using s32_e32_pmr_dense_grid = dense_grid<
+    s32_space_policy<NDim>, u32_entry_policy,
+    std::pmr::polymorphic_allocator<u32_entry_policy::entry>>;
+
 } // namespace ungrd
 
 #endif // UNGRD_DENSE_GRID_HPP_68F5A7B39EA04EF4A38B5422B2E0A742
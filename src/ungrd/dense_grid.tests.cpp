@@ -2,7 +2,175 @@
 
 #include "dense_grid.hpp"
 #include "grid.tests.hpp"
+#include "slab_memory_resource.hpp"
+
+#include "cxx/modulo.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
 
 using namespace ungrd;
 
 TEST(DenseGrid, Correctness) { T_Grid_Correctness<s32_e32_dense_grid<3>>(); }
+
+TEST(DenseGrid, SlabMemoryResourceCorrectness) {
+  slab_memory_resource resource;
+  T_Grid_Correctness<s32_e32_pmr_dense_grid<3>>(&resource);
+}
+
+TEST(DenseGrid, SlabMemoryResourceClear) {
+  T_Grid_SlabMemoryResourceClear<s32_e32_pmr_dense_grid<3>>();
+}
+
+TEST(DenseGrid, RandomDifferentialUpdates) {
+  T_Grid_RandomDifferentialUpdates<s32_e32_dense_grid<3>>();
+}
+
+TEST(DenseGrid, BoxQuery) { T_Grid_BoxQuery<s32_e32_dense_grid<3>>(); }
+
+TEST(DenseGrid, S16E16BoxQuery) { T_Grid_BoxQuery<s16_e16_dense_grid<3>>(); }
+
+TEST(DenseGrid, Payload) {
+  T_Grid_Payload<dense_grid<s32_space_policy<3>, u32_f32xN_entry_policy<3>>>();
+}
+
+TEST(DenseGrid, SlabMemoryResourcePayload) {
+  using entry_policy = u32_f32xN_entry_policy<3>;
+  using grid_type = dense_grid<
+      s32_space_policy<3>, entry_policy,
+      std::pmr::polymorphic_allocator<entry_policy::entry>>;
+
+  slab_memory_resource resource;
+  T_Grid_Payload<grid_type>(&resource);
+}
+
+TEST(DenseGrid, TrackedUpdate) {
+  T_Grid_TrackedUpdate<s32_e32_dense_grid<3>>();
+}
+
+TEST(DenseGrid, S16E16Correctness) {
+  T_Grid_Correctness<s16_e16_dense_grid<3>>();
+}
+
+TEST(DenseGrid, S16E16RandomDifferentialUpdates) {
+  T_Grid_RandomDifferentialUpdates<s16_e16_dense_grid<3>>();
+}
+
+TEST(DenseGrid, S16E16TrackedUpdate) {
+  T_Grid_TrackedUpdate<s16_e16_dense_grid<3>>();
+}
+
+TEST(DenseGrid, S16E16WideBox) {
+  using grid_type = s16_e16_dense_grid<1>;
+  using position_type = grid_type::space_policy::position;
+
+  // the box spans almost all cells that int16 positions can count
+  std::vector<std::pair<position_type, std::uint16_t>> input = {
+      {{-16383}, 0}, {{0}, 1}, {{16382}, 2}};
+
+  grid_type grid;
+  grid.update(input);
+  ASSERT_EQ(3u, grid.count_filled_cells());
+  ASSERT_EQ(
+      (std::pair{position_type{-16383}, position_type{16382}}),
+      grid.bounding_box());
+
+  for (auto const &[cpos, entry] : input) {
+    std::vector<std::uint16_t> entries;
+    grid.foreach_entry_at_position(
+        cpos, [&entries](auto const other) { entries.push_back(other); });
+    ASSERT_EQ(std::vector<std::uint16_t>{entry}, entries);
+  }
+}
+
+TEST(DenseGrid, Periodic) {
+  using space_policy = s32_periodic_space_policy<8, 5, 6>;
+  using grid_type = dense_grid<space_policy, u32_entry_policy>;
+  using position_type = space_policy::position;
+
+  constexpr auto extents = space_policy::extents();
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{-20, 20};
+  std::uniform_int_distribution<int> box_dis{-12, 12};
+  std::uniform_int_distribution<int> side_dis{0, 9};
+
+  std::vector<std::pair<position_type, std::uint32_t>> input;
+  for (std::uint32_t entry = 0; entry < 300; ++entry) {
+    position_type cpos;
+    for (size_t dim = 0; dim < 3; ++dim)
+      cpos[dim] = coordinate_dis(gen);
+    input.emplace_back(cpos, entry);
+  }
+
+  grid_type grid;
+  grid.update(input);
+
+  // positions are stored wrapped and can be looked up unwrapped
+  grid.foreach_position([&](auto const &cpos) {
+    for (size_t dim = 0; dim < 3; ++dim) {
+      ASSERT_LE(0, cpos[dim]);
+      ASSERT_LT(cpos[dim], extents[dim]);
+    }
+  });
+  for (auto const &[cpos, entry] : input) {
+    bool found = false;
+    grid.foreach_entry_at_position(
+        cpos, [&found, entry](auto const other) { found |= other == entry; });
+    ASSERT_TRUE(found);
+  }
+
+  // every entry in a wrapped box is found exactly once
+  for (size_t round = 0; round < 200; ++round) {
+    position_type lo, hi;
+    for (size_t dim = 0; dim < 3; ++dim) {
+      lo[dim] = box_dis(gen);
+      hi[dim] = lo[dim] + side_dis(gen);
+    }
+
+    std::vector<std::uint32_t> expected;
+    for (auto const &[cpos, entry] : input) {
+      bool inside = true;
+      for (size_t dim = 0; dim < 3; ++dim)
+        inside = inside and (hi[dim] - lo[dim] + 1 >= extents[dim] or
+                             modulo(cpos[dim] - lo[dim], extents[dim]) <=
+                                 hi[dim] - lo[dim]);
+      if (inside)
+        expected.push_back(entry);
+    }
+
+    std::vector<std::uint32_t> entries;
+    grid.foreach_entry_in_box(
+        lo, hi, [&entries](auto const entry) { entries.push_back(entry); });
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(entries.begin(), entries.end());
+    ASSERT_EQ(expected, entries);
+  }
+
+  // moving entries across the faces
+  std::vector<std::pair<position_type, std::uint32_t>> fresh, stale;
+  for (auto &[cpos, entry] : input) {
+    if (entry % 3 != 0)
+      continue;
+    stale.emplace_back(cpos, entry);
+    cpos[0] += extents[0] * 3 + 1;
+    fresh.emplace_back(cpos, entry);
+  }
+  grid.differential_update(fresh, stale);
+
+  size_t entry_count = 0;
+  grid.foreach_entry_in_box(
+      space_policy::most_negative_position(),
+      space_policy::most_positive_position(),
+      [&entry_count](auto const) { ++entry_count; });
+  ASSERT_EQ(input.size(), entry_count);
+
+  for (auto const &[cpos, entry] : fresh) {
+    bool found = false;
+    grid.foreach_entry_at_position(
+        cpos, [&found, entry](auto const other) { found |= other == entry; });
+    ASSERT_TRUE(found);
+  }
+}
@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "double_buffered_grid.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace ungrd;
+
+namespace {
+
+// a few frames of entries in 32^3 cells, every frame moves every fourth entry
+template <typename Grid>
+auto random_frames(size_t const entry_count) {
+  using position_type = typename Grid::space_policy::position;
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{0, 31};
+  std::uniform_int_distribution<int> step_dis{-1, 1};
+
+  std::vector<std::vector<position_type>> frames(8);
+  frames[0].resize(entry_count);
+  for (auto &cpos : frames[0])
+    for (auto &index : cpos)
+      index = coordinate_dis(gen);
+  for (size_t frame = 1; frame < frames.size(); ++frame) {
+    frames[frame] = frames[frame - 1];
+    for (size_t entry = frame % 4; entry < entry_count; entry += 4)
+      for (auto &index : frames[frame][entry])
+        index += step_dis(gen);
+  }
+  return frames;
+}
+
+// sums the entries of the 3^3 neighbourhood of every cell of a frame
+template <typename Grid, typename TPositions>
+size_t query_frame(Grid const &grid, TPositions const &cposes) {
+  size_t sum = 0;
+  for (size_t entry = 0; entry < cposes.size(); entry += 16) {
+    auto lo = cposes[entry], hi = cposes[entry];
+    for (size_t dim = 0; dim < lo.size(); ++dim) {
+      --lo[dim];
+      ++hi[dim];
+    }
+    grid.foreach_entry_in_box(
+        lo, hi, [&sum](auto const other) { sum += other; });
+  }
+  return sum;
+}
+
+} // namespace
+
+// Updates a grid and then queries it, one after the other.
+template <typename Grid>
+void BMT_DoubleBufferedGrid_Sequential(benchmark::State &state) {
+  auto const frames = random_frames<Grid>(state.range(0));
+
+  Grid grid;
+  size_t frame = 0;
+  for (auto _ : state) {
+    grid.tracked_update(frames[frame]);
+    benchmark::DoNotOptimize(query_frame(grid, frames[frame]));
+    frame = (frame + 1) % frames.size();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BMT_DoubleBufferedGrid_Sequential, s32_e32_dense_grid<3>)
+    ->Arg(32 * 32 * 32 * 8)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BMT_DoubleBufferedGrid_Sequential, s32_e32_compact_grid<3>)
+    ->Arg(32 * 32 * 32 * 8)
+    ->Unit(benchmark::kMillisecond);
+
+// Queries the front grid of a frame while the next frame is updated.
+template <typename Grid>
+void BMT_DoubleBufferedGrid_Overlapped(benchmark::State &state) {
+  auto const frames = random_frames<Grid>(state.range(0));
+
+  double_buffered_grid<Grid> grid;
+  grid.begin_tracked_update(frames[0]);
+  grid.finish_update();
+
+  size_t frame = 0;
+  for (auto _ : state) {
+    auto const next = (frame + 1) % frames.size();
+    grid.begin_tracked_update(frames[next]);
+    benchmark::DoNotOptimize(query_frame(grid, frames[frame]));
+    grid.finish_update();
+    frame = next;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BMT_DoubleBufferedGrid_Overlapped, s32_e32_dense_grid<3>)
+    ->Arg(32 * 32 * 32 * 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BMT_DoubleBufferedGrid_Overlapped, s32_e32_compact_grid<3>)
+    ->Arg(32 * 32 * 32 * 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
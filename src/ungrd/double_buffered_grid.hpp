@@ -0,0 +1,177 @@
+#ifndef UNGRD_DOUBLE_BUFFERED_GRID_HPP_301291CBF04647DAA7CD9B0B8852854C
+#define UNGRD_DOUBLE_BUFFERED_GRID_HPP_301291CBF04647DAA7CD9B0B8852854C
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <cassert>
+#include <cstddef>
+
+namespace ungrd {
+
+// Two grids, the front grid serves queries while the back grid is updated with
+// the input of the next frame on a background thread. finish_update waits for
+// the update and swaps the grids.
+//
+// Every grid is updated every other frame, so it reuses the cells of the frame
+// before the last one. begin_update refills them, begin_tracked_update only
+// moves the entries that changed cells since then. Steady state frames whose
+// entries stay within the cells of the grid do not allocate either way.
+template <typename TGrid>
+class double_buffered_grid {
+public:
+  using grid_type = TGrid;
+  using space_policy = typename grid_type::space_policy;
+  using entry_policy = typename grid_type::entry_policy;
+
+private:
+  using position_type = typename space_policy::position;
+
+public:
+  // The grid of the last finished update. References to it are invalidated by
+  // the next call to finish_update.
+  grid_type const &front() const {
+    return grids_[front_.load(std::memory_order_acquire)];
+  }
+
+  size_t count_filled_cells() const { return front().count_filled_cells(); }
+
+  auto stats() const { return front().stats(); }
+
+  template <typename FCallback>
+  void foreach_entry_at_position(
+      position_type const &cpos, FCallback callback) const {
+    front().foreach_entry_at_position(cpos, std::move(callback));
+  }
+
+  template <typename FCallback>
+  void foreach_entry_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    front().foreach_entry_in_box(lo, hi, std::move(callback));
+  }
+
+  template <typename FCallback>
+  void foreach_position(FCallback callback) const {
+    front().foreach_position(std::move(callback));
+  }
+
+public:
+  // Starts updating the back grid with input on the background thread. input
+  // has to stay valid until finish_update returns.
+  template <typename TInput>
+  void begin_update(TInput const &input) {
+    begin([&input](grid_type &grid) { grid.update(input); });
+  }
+
+  // Starts a tracked_update of the back grid with cposes on the background
+  // thread. cposes has to stay valid until finish_update returns.
+  template <typename TPositions>
+  void begin_tracked_update(TPositions const &cposes) {
+    begin([&cposes](grid_type &grid) { grid.tracked_update(cposes); });
+  }
+
+  bool updating() const {
+    std::lock_guard lock{mutex_};
+    return static_cast<bool>(task_);
+  }
+
+  // Waits until the back grid is updated and makes it the front grid. Rethrows
+  // exceptions of the update, the grids are not swapped then. Returns false
+  // without swapping if no update was started since the last call.
+  bool finish_update() {
+    std::unique_lock lock{mutex_};
+    if (not std::exchange(started_, false))
+      return false;
+
+    done_.wait(lock, [this] { return not task_; });
+
+    if (auto error = std::exchange(error_, nullptr))
+      std::rethrow_exception(error);
+
+    front_.store(1 - front_.load(), std::memory_order_release);
+    return true;
+  }
+
+private:
+  void begin(std::function<void(grid_type &)> task) {
+    {
+      std::lock_guard lock{mutex_};
+      assert(not started_ and "finish the previous update first");
+      started_ = true;
+      task_ = std::move(task);
+    }
+    pending_.notify_one();
+  }
+
+  void run() {
+    std::unique_lock lock{mutex_};
+    while (true) {
+      pending_.wait(lock, [this] { return stop_ or task_; });
+      if (stop_)
+        return;
+
+      // the front grid only changes in finish_update, which waits for this
+      auto &back = grids_[1 - front_.load()];
+
+      lock.unlock();
+      std::exception_ptr error;
+      try {
+        task_(back);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+
+      error_ = error;
+      task_ = nullptr;
+      done_.notify_all();
+    }
+  }
+
+public:
+  template <typename... TArgs>
+  explicit double_buffered_grid(TArgs const &...args)
+      : grids_{grid_type{args...}, grid_type{args...}},
+        worker_{[this] { run(); }} {}
+
+  ~double_buffered_grid() {
+    {
+      std::unique_lock lock{mutex_};
+      done_.wait(lock, [this] { return not task_; });
+      stop_ = true;
+    }
+    pending_.notify_one();
+    worker_.join();
+  }
+
+  double_buffered_grid(double_buffered_grid const &) = delete;
+  double_buffered_grid &operator=(double_buffered_grid const &) = delete;
+
+private:
+  std::array<grid_type, 2> grids_;
+  std::atomic<size_t> front_ = 0;
+
+  mutable std::mutex mutex_;
+  std::condition_variable pending_;
+  std::condition_variable done_;
+  std::function<void(grid_type &)> task_ = {};
+  std::exception_ptr error_ = nullptr;
+  bool stop_ = false;
+
+  // an update was begun and not finished yet
+  bool started_ = false;
+
+  // started last, once everything it uses is initialized
+  std::thread worker_;
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_DOUBLE_BUFFERED_GRID_HPP_301291CBF04647DAA7CD9B0B8852854C
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "double_buffered_grid.hpp"
+#include "slab_memory_resource.hpp"
+
+#include "cxx/map.hpp"
+#include "cxx/set.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::atomic<size_t> allocation_count = 0;
+
+} // namespace
+
+// Counts the allocations of the whole test binary. GCC warns about the free
+// in the replaced operator delete once it is inlined after an operator new.
+#if defined(__GNUC__) and not defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(size_t const size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void *memory = std::malloc(size == 0 ? 1 : size))
+    return memory;
+  throw std::bad_alloc{};
+}
+
+void *operator new(size_t const size, std::align_val_t const alignment) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  auto const align = static_cast<size_t>(alignment);
+  auto const rounded = (size + align - 1) / align * align;
+  if (void *memory = std::aligned_alloc(align, rounded == 0 ? align : rounded))
+    return memory;
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+void operator delete(void *memory, size_t) noexcept {
+  ::operator delete(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete(
+    void *memory, size_t, std::align_val_t const alignment) noexcept {
+  ::operator delete(memory, alignment);
+}
+
+#if defined(__GNUC__) and not defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+using namespace ungrd;
+
+namespace {
+
+// Queries the front grid while the next frame is built and checks that it
+// always holds the last finished frame.
+template <typename Grid, typename... TArgs>
+void T_DoubleBufferedGrid_Frames(bool const tracked, TArgs &&...args) {
+  using position_type = typename Grid::space_policy::position;
+  using entry_type = typename Grid::entry_policy::entry;
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{-6, 6};
+  std::uniform_int_distribution<int> step_dis{-1, 1};
+
+  std::vector<std::vector<position_type>> frames(12);
+  frames[0].resize(300);
+  for (auto &cpos : frames[0])
+    for (auto &index : cpos)
+      index = coordinate_dis(gen);
+  for (size_t frame = 1; frame < frames.size(); ++frame) {
+    frames[frame] = frames[frame - 1];
+    for (size_t entry = frame % 4; entry < frames[frame].size(); entry += 4)
+      for (auto &index : frames[frame][entry])
+        index += step_dis(gen);
+  }
+
+  std::vector<std::vector<std::pair<position_type, entry_type>>> inputs;
+  for (auto const &cposes : frames) {
+    auto &input = inputs.emplace_back();
+    for (size_t entry = 0; entry < cposes.size(); ++entry)
+      input.emplace_back(cposes[entry], entry);
+  }
+
+  double_buffered_grid<Grid> grid{std::forward<TArgs>(args)...};
+
+  auto const begin_frame = [&](size_t const frame) {
+    if (tracked)
+      grid.begin_tracked_update(frames[frame]);
+    else
+      grid.begin_update(inputs[frame]);
+  };
+
+  auto const check = [&](std::vector<position_type> const &cposes) {
+    hash_map<position_type, hash_set<entry_type>> expected;
+    for (size_t entry = 0; entry < cposes.size(); ++entry)
+      expected[cposes[entry]].insert(entry);
+
+    ASSERT_EQ(expected.size(), grid.count_filled_cells());
+    grid.foreach_position([&](auto const &cpos) {
+      hash_set<entry_type> entries;
+      grid.foreach_entry_at_position(
+          cpos, [&entries](auto const entry) { entries.insert(entry); });
+      ASSERT_EQ(expected[cpos], entries);
+    });
+  };
+
+  begin_frame(0);
+  ASSERT_TRUE(grid.finish_update());
+  check(frames[0]);
+
+  for (size_t frame = 1; frame < frames.size(); ++frame) {
+    begin_frame(frame);
+    check(frames[frame - 1]);
+    ASSERT_TRUE(grid.finish_update());
+    ASSERT_FALSE(grid.updating());
+    check(frames[frame]);
+  }
+
+  // without a pending update the grids stay as they are
+  ASSERT_FALSE(grid.finish_update());
+  check(frames.back());
+
+  // the destructor waits for a pending update
+  begin_frame(0);
+}
+
+// Moves every 50th entry into the cell of another entry each frame, so the
+// filled cells keep their entry counts, and checks that the frames after the
+// first few do not allocate.
+template <typename Grid>
+void T_DoubleBufferedGrid_SteadyState(bool const tracked) {
+  using position_type = typename Grid::space_policy::position;
+  using entry_type = typename Grid::entry_policy::entry;
+
+  size_t const entry_count = 20000;
+  size_t const warm_up_frames = 4;
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{-12, 12};
+  std::uniform_int_distribution<size_t> entry_dis{0, entry_count - 1};
+
+  std::vector<std::vector<position_type>> frames(16);
+  frames[0].resize(entry_count);
+  for (auto &cpos : frames[0])
+    for (auto &index : cpos)
+      index = coordinate_dis(gen);
+  for (size_t frame = 1; frame < frames.size(); ++frame) {
+    frames[frame] = frames[frame - 1];
+    for (size_t move = 0; move < entry_count / 50; ++move)
+      std::swap(frames[frame][entry_dis(gen)], frames[frame][entry_dis(gen)]);
+  }
+
+  std::vector<std::vector<std::pair<position_type, entry_type>>> inputs;
+  for (auto const &cposes : frames) {
+    auto &input = inputs.emplace_back();
+    for (size_t entry = 0; entry < cposes.size(); ++entry)
+      input.emplace_back(cposes[entry], entry);
+  }
+
+  double_buffered_grid<Grid> grid;
+
+  size_t allocations = 0;
+  for (size_t frame = 0; frame < frames.size(); ++frame) {
+    if (frame == warm_up_frames)
+      allocations = allocation_count.load();
+
+    if (tracked)
+      grid.begin_tracked_update(frames[frame]);
+    else
+      grid.begin_update(inputs[frame]);
+    ASSERT_TRUE(grid.finish_update());
+  }
+  allocations = allocation_count.load() - allocations;
+
+  ASSERT_EQ(0, allocations);
+
+  hash_set<position_type> expected{frames.back().begin(), frames.back().end()};
+  ASSERT_EQ(expected.size(), grid.count_filled_cells());
+}
+
+} // namespace
+
+TEST(DoubleBufferedGrid, DenseGrid) {
+  T_DoubleBufferedGrid_Frames<s32_e32_dense_grid<3>>(false);
+}
+
+TEST(DoubleBufferedGrid, DenseGridTracked) {
+  T_DoubleBufferedGrid_Frames<s32_e32_dense_grid<3>>(true);
+}
+
+TEST(DoubleBufferedGrid, CompactGridTracked) {
+  T_DoubleBufferedGrid_Frames<s32_e32_compact_grid<3>>(true);
+}
+
+TEST(DoubleBufferedGrid, SlabMemoryResource) {
+  slab_memory_resource resource;
+  T_DoubleBufferedGrid_Frames<s32_e32_pmr_compact_grid<3>>(false, &resource);
+}
+
+TEST(DoubleBufferedGrid, DenseGridSteadyState) {
+  T_DoubleBufferedGrid_SteadyState<s32_e32_dense_grid<3>>(false);
+}
+
+TEST(DoubleBufferedGrid, DenseGridTrackedSteadyState) {
+  T_DoubleBufferedGrid_SteadyState<s32_e32_dense_grid<3>>(true);
+}
+
+TEST(DoubleBufferedGrid, CompactGridSteadyState) {
+  T_DoubleBufferedGrid_SteadyState<s32_e32_compact_grid<3>>(false);
+}
+
+TEST(DoubleBufferedGrid, CompactGridTrackedSteadyState) {
+  T_DoubleBufferedGrid_SteadyState<s32_e32_compact_grid<3>>(true);
+}
@@ -0,0 +1,135 @@
+#include <benchmark/benchmark.h>
+
+#include "dense_grid.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace ungrd;
+
+namespace {
+
+using point_type = std::array<float, 3>;
+using position_type = s32_space_policy<3>::position;
+
+position_type point_to_cpos(point_type const &point) {
+  position_type cpos;
+  for (size_t dim = 0; dim < 3; ++dim)
+    cpos[dim] = static_cast<std::int32_t>(std::floor(point[dim]));
+  return cpos;
+}
+
+// uniformly random points in a box of 32^3 cells, with the given number of
+// points per cell on average
+std::vector<point_type> random_points(size_t const points_per_cell) {
+  std::mt19937 gen{0};
+  std::uniform_real_distribution<float> dis{0.f, 32.f};
+
+  std::vector<point_type> points(32 * 32 * 32 * points_per_cell);
+  for (auto &point : points)
+    for (auto &coordinate : point)
+      coordinate = dis(gen);
+  return points;
+}
+
+template <typename FCount>
+void count_neighbours(
+    benchmark::State &state, std::vector<point_type> const &points,
+    FCount count_in_box) {
+  size_t query = 0;
+  for (auto _ : state) {
+    auto const &point = points[query];
+    auto cpos = point_to_cpos(point);
+
+    position_type lo, hi;
+    for (size_t dim = 0; dim < 3; ++dim) {
+      lo[dim] = cpos[dim] - 1;
+      hi[dim] = cpos[dim] + 1;
+    }
+    benchmark::DoNotOptimize(count_in_box(point, lo, hi));
+
+    query = (query + 7919) % points.size();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+// Counts the neighbours within one cell size of a point, gathering the
+// positions of the entries from an external array.
+static void BM_CountNeighbours_External(benchmark::State &state) {
+  using grid_type = s32_e32_dense_grid<3>;
+
+  auto const points = random_points(state.range(0));
+
+  grid_type grid;
+  {
+    std::vector<std::pair<position_type, std::uint32_t>> input;
+    for (std::uint32_t entry = 0; entry < points.size(); ++entry)
+      input.emplace_back(point_to_cpos(points[entry]), entry);
+    grid.update(input);
+  }
+
+  count_neighbours(
+      state, points,
+      [&](point_type const &point, position_type const &lo,
+          position_type const &hi) {
+        size_t count = 0;
+        grid.foreach_entry_in_box(lo, hi, [&](std::uint32_t const entry) {
+          auto const &other = points[entry];
+          float distance2 = 0;
+          for (size_t dim = 0; dim < 3; ++dim)
+            distance2 += (other[dim] - point[dim]) * (other[dim] - point[dim]);
+          count += distance2 < 1.f;
+        });
+        return count;
+      });
+}
+BENCHMARK(BM_CountNeighbours_External)->Arg(4)->Arg(16);
+
+// Counts the neighbours within one cell size of a point, streaming the
+// positions stored as payloads in the cells.
+static void BM_CountNeighbours_Payload(benchmark::State &state) {
+  using grid_type = dense_grid<s32_space_policy<3>, u32_f32xN_entry_policy<3>>;
+
+  auto const points = random_points(state.range(0));
+
+  grid_type grid;
+  {
+    std::vector<std::tuple<position_type, std::uint32_t, point_type>> input;
+    for (std::uint32_t entry = 0; entry < points.size(); ++entry)
+      input.emplace_back(point_to_cpos(points[entry]), entry, points[entry]);
+    grid.update(input);
+  }
+
+  count_neighbours(
+      state, points,
+      [&](point_type const &point, position_type const &lo,
+          position_type const &hi) {
+        size_t count = 0;
+        grid.foreach_cell_in_box(lo, hi, [&](auto const &view) {
+          float const *xs = view.payload[0].data();
+          float const *ys = view.payload[1].data();
+          float const *zs = view.payload[2].data();
+          size_t const size = view.size();
+
+          size_t cell_count = 0;
+#pragma omp simd reduction(+ : cell_count)
+          for (size_t index = 0; index < size; ++index) {
+            float const dx = xs[index] - point[0];
+            float const dy = ys[index] - point[1];
+            float const dz = zs[index] - point[2];
+            cell_count += dx * dx + dy * dy + dz * dz < 1.f;
+          }
+          count += cell_count;
+        });
+        return count;
+      });
+}
+BENCHMARK(BM_CountNeighbours_Payload)->Arg(4)->Arg(16);
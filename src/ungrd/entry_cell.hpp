@@ -0,0 +1,216 @@
+#ifndef UNGRD_ENTRY_CELL_HPP_7DF794CE80AB44BCAF93C65B43ACE5A1
+#define UNGRD_ENTRY_CELL_HPP_7DF794CE80AB44BCAF93C65B43ACE5A1
+
+#include "cxx/narrow.hpp"
+
+#include "entry_policy.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace ungrd {
+
+// Read-only view of the entries of a cell and of their payloads. Every payload
+// component is a contiguous array parallel to the entries.
+template <typename PEntry>
+struct entry_cell_view {
+  using entry_type = typename PEntry::entry;
+  using payload_traits = ungrd::payload_traits<typename PEntry::payload>;
+  using component_type = typename payload_traits::component;
+
+  static constexpr size_t component_count = payload_traits::component_count;
+
+  size_t size() const { return entries.size(); }
+
+  std::span<entry_type const> entries;
+  std::array<std::span<component_type const>, component_count> payload;
+};
+
+// The entries of a cell of a grid. Payloads are stored as a struct of arrays,
+// one vector per payload component.
+template <typename PEntry, typename TAllocator>
+class entry_cell {
+  using entry_type = typename PEntry::entry;
+  using payload_type = typename PEntry::payload;
+  using payload_traits = ungrd::payload_traits<payload_type>;
+  using component_type = typename payload_traits::component;
+
+  static constexpr bool has_payload = not std::is_void_v<payload_type>;
+  static constexpr size_t component_count = payload_traits::component_count;
+
+  using entry_vector = std::vector<entry_type, TAllocator>;
+  using component_allocator = typename std::allocator_traits<
+      TAllocator>::template rebind_alloc<component_type>;
+  using component_vector = std::vector<component_type, component_allocator>;
+  using payload_vectors = std::array<component_vector, component_count>;
+
+public:
+  using view_type = entry_cell_view<PEntry>;
+
+public:
+  bool empty() const { return entries_.empty(); }
+
+  size_t size() const { return entries_.size(); }
+
+  auto const &entries() const { return entries_; }
+
+  template <typename FCallback>
+  void foreach_entry(FCallback callback) const {
+    for (auto const entry : entries_)
+      callback(entry);
+  }
+
+  view_type view() const {
+    view_type view;
+    view.entries = entries_;
+    for (size_t component = 0; component < component_count; ++component)
+      view.payload[component] = payload_[component];
+    return view;
+  }
+
+public:
+  void reserve_entries(size_t count) {
+    entries_.reserve(count);
+    for (auto &components : payload_)
+      components.reserve(count);
+  }
+
+  void clear_entries() {
+    entries_.clear();
+    for (auto &components : payload_)
+      components.clear();
+  }
+
+  void add_entry(entry_type entry)
+    requires(not has_payload)
+  {
+    using std::begin, std::end;
+    auto it = std::find(begin(entries_), end(entries_), entry);
+    if (it == end(entries_))
+      entries_.emplace_back(entry);
+  }
+
+  // adds the entry or replaces the payload of an existing entry
+  template <typename TPayload>
+    requires has_payload
+  void add_entry(entry_type entry, TPayload const &payload) {
+    using std::begin, std::end;
+    auto it = std::find(begin(entries_), end(entries_), entry);
+    if (it == end(entries_)) {
+      entries_.emplace_back(entry);
+      for (size_t component = 0; component < component_count; ++component)
+        payload_[component].emplace_back(payload[component]);
+    } else {
+      auto const index = it - begin(entries_);
+      for (size_t component = 0; component < component_count; ++component)
+        payload_[component][index] = payload[component];
+    }
+  }
+
+  // adds the entry of an input element (cpos, entry) or (cpos, entry, payload)
+  template <typename TElement>
+  void add_input_entry(TElement const &element) {
+    if constexpr (has_payload)
+      add_entry(
+          narrow<entry_type>(std::get<1>(element)), std::get<2>(element));
+    else
+      add_entry(narrow<entry_type>(std::get<1>(element)));
+  }
+
+  void erase_entry(entry_type entry) {
+    using std::begin, std::end;
+    auto it = std::find(begin(entries_), end(entries_), entry);
+    if (it != end(entries_)) {
+      auto const index = it - begin(entries_);
+      entries_.erase(it);
+      for (auto &components : payload_)
+        components.erase(begin(components) + index);
+    }
+  }
+
+  friend void swap(entry_cell &a, entry_cell &b) {
+    using std::swap;
+    swap(a.entries_, b.entries_);
+    swap(a.payload_, b.payload_);
+  }
+
+public:
+  entry_cell() = default;
+
+  explicit entry_cell(TAllocator const &allocator)
+      : entries_{allocator}, payload_{make_payload_vectors(allocator)} {}
+
+  // Moves the entries of other into memory from allocator. They are moved
+  // one by one when the allocators do not compare equal.
+  entry_cell(entry_cell &&other, TAllocator const &allocator)
+      : entries_{std::move(other.entries_), allocator},
+        payload_{make_payload_vectors(allocator)} {
+    for (size_t component = 0; component < component_count; ++component)
+      payload_[component] = std::move(other.payload_[component]);
+  }
+
+private:
+  static payload_vectors make_payload_vectors(TAllocator const &allocator) {
+    return [&allocator]<size_t... NComponents>(
+               std::index_sequence<NComponents...>) {
+      return payload_vectors{
+          ((void)NComponents, component_vector{allocator})...};
+    }(std::make_index_sequence<component_count>{});
+  }
+
+private:
+  entry_vector entries_ = {};
+  payload_vectors payload_ = {};
+};
+
+// The grids keep their cells in vectors and construct every cell from the
+// allocator of the grid. Copying a cell would not keep its allocator, copies
+// of std::pmr::polymorphic_allocator use the default resource. Such allocators
+// cannot be assigned either, so the grids move assign by swapping their
+// contents when the allocators compare equal and otherwise by move_cells, the
+// element-wise move the std containers fall back to.
+
+// Resizes cells to count cells, the new cells allocate from allocator.
+template <typename TCell, typename TAllocator>
+void resize_cells(
+    std::vector<TCell> &cells, size_t const count,
+    TAllocator const &allocator) {
+  if (cells.size() > count)
+    cells.erase(cells.begin() + count, cells.end());
+
+  cells.reserve(count);
+  while (cells.size() < count)
+    cells.emplace_back(allocator);
+}
+
+// count empty cells that allocate from allocator
+template <typename TCell, typename TAllocator>
+std::vector<TCell> make_cells(size_t const count, TAllocator const &allocator) {
+  std::vector<TCell> cells;
+  resize_cells(cells, count, allocator);
+  return cells;
+}
+
+// Moves cells into new cells that allocate from allocator.
+template <typename TCell, typename TAllocator>
+std::vector<TCell>
+move_cells(std::vector<TCell> &&cells, TAllocator const &allocator) {
+  std::vector<TCell> moved;
+  moved.reserve(cells.size());
+  for (auto &cell : cells)
+    moved.emplace_back(std::move(cell), allocator);
+  cells.clear();
+  return moved;
+}
+
+} // namespace ungrd
+
+#endif // UNGRD_ENTRY_CELL_HPP_7DF794CE80AB44BCAF93C65B43ACE5A1
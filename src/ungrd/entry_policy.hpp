@@ -1,18 +1,62 @@
 #ifndef UNGRD_ENTRY_POLICY_HPP_583302C5034A450E8E02ACB89FE58F51
 #define UNGRD_ENTRY_POLICY_HPP_583302C5034A450E8E02ACB89FE58F51
 
+#include <array>
+
+#include <cstddef>
 #include <cstdint>
 
 namespace ungrd {
 
-template <typename TEntry>
+// The grids store entries of type TEntry. If TPayload is not void, every entry
+// carries a payload that is stored next to it in the cells. Payloads are fixed
+// size arrays, e.g. std::array<float, 3> for positions.
+template <typename TEntry, typename TPayload = void>
 struct entry_policy {
   using entry = TEntry;
+  using payload = TPayload;
 };
 
+using u16_entry_policy = entry_policy<std::uint16_t>;
 using u32_entry_policy = entry_policy<std::uint32_t>;
 using u64_entry_policy = entry_policy<std::uint64_t>;
 
+template <std::size_t NComponents>
+using u32_f32xN_entry_policy =
+    entry_policy<std::uint32_t, std::array<float, NComponents>>;
+
+// Entries without payload that compact_grid stores in packed_entry_cells,
+// sorted and delta encoded.
+template <typename TEntry>
+struct packed_entry_policy {
+  using entry = TEntry;
+  using payload = void;
+
+  static constexpr bool packed = true;
+};
+
+using u32_packed_entry_policy = packed_entry_policy<std::uint32_t>;
+using u64_packed_entry_policy = packed_entry_policy<std::uint64_t>;
+
+template <typename PEntry>
+inline constexpr bool is_packed_entry_policy =
+    requires { requires PEntry::packed; };
+
+template <typename TPayload>
+struct payload_traits;
+
+template <>
+struct payload_traits<void> {
+  using component = std::byte; // unused
+  static constexpr std::size_t component_count = 0;
+};
+
+template <typename TComponent, std::size_t NComponents>
+struct payload_traits<std::array<TComponent, NComponents>> {
+  using component = TComponent;
+  static constexpr std::size_t component_count = NComponents;
+};
+
 } // namespace ungrd
 
 #endif // UNGRD_ENTRY_POLICY_HPP_583302C5034A450E8E02ACB89FE58F51
@@ -0,0 +1,97 @@
+#ifndef UNGRD_ENTRY_TRACKER_HPP_8AC272C58F294524B587FAD5D28A46D8
+#define UNGRD_ENTRY_TRACKER_HPP_8AC272C58F294524B587FAD5D28A46D8
+
+#include "cxx/narrow.hpp"
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ungrd {
+
+// Remembers the cell position of every entry 0, 1, ..., n-1 of a grid and
+// turns the new positions of all entries into the fresh and stale lists of a
+// differential update. The positions are compared in a parallel SIMD loop, only
+// the entries that changed cells are written to the lists.
+//
+// Whole positions are remembered rather than cell indices, the stale list needs
+// the old positions and the cell indices of a dense grid change whenever it is
+// reshaped. Narrower space policies like s16_space_policy shrink them. Grids
+// only allocate a tracker on their first tracked_update.
+template <typename TPosition, typename TEntry>
+class entry_tracker {
+  static constexpr std::size_t ndim = std::tuple_size_v<TPosition>;
+
+  using element_type = std::pair<TPosition, TEntry>;
+
+public:
+  // the entries that entered and left cells in the last call to track
+  std::vector<element_type> const &fresh() const { return fresh_; }
+  std::vector<element_type> const &stale() const { return stale_; }
+
+public:
+  // Compares cposes with the remembered positions. Returns false if they
+  // cannot be compared because the tracker is invalid or the number of entries
+  // changed, then every entry is fresh and the grid has to be rebuilt.
+  template <typename TPositions>
+  bool track(TPositions const &cposes) {
+    using std::size;
+    std::size_t const entry_count = size(cposes);
+
+    fresh_.clear();
+    stale_.clear();
+
+    if (not valid_ or entry_count != cposes_.size()) {
+      cposes_.resize(entry_count);
+      for (std::size_t entry = 0; entry < entry_count; ++entry) {
+        cposes_[entry] = cposes[entry];
+        fresh_.emplace_back(cposes[entry], narrow<TEntry>(entry));
+      }
+      return false;
+    }
+
+    changed_.resize(entry_count);
+    auto *const changed = changed_.data();
+    auto const *const old_cposes = cposes_.data();
+
+#pragma omp parallel for simd schedule(static)
+    for (std::size_t entry = 0; entry < entry_count; ++entry) {
+      bool same = true;
+      for (std::size_t dim = 0; dim < ndim; ++dim)
+        same &= cposes[entry][dim] == old_cposes[entry][dim];
+      changed[entry] = not same;
+    }
+
+    for (std::size_t entry = 0; entry < entry_count; ++entry) {
+      if (changed[entry]) {
+        stale_.emplace_back(cposes_[entry], narrow<TEntry>(entry));
+        cposes_[entry] = cposes[entry];
+        fresh_.emplace_back(cposes_[entry], narrow<TEntry>(entry));
+      }
+    }
+    return true;
+  }
+
+  // The remembered positions no longer match the grid, e.g. after the grid was
+  // updated without the tracker. The next call to track starts over.
+  void invalidate() { valid_ = false; }
+
+  // The grid has been updated with the lists of the last call to track.
+  void validate() { valid_ = true; }
+
+private:
+  bool valid_ = false;
+
+  std::vector<TPosition> cposes_ = {};
+  std::vector<std::uint8_t> changed_ = {};
+
+  std::vector<element_type> fresh_ = {};
+  std::vector<element_type> stale_ = {};
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_ENTRY_TRACKER_HPP_8AC272C58F294524B587FAD5D28A46D8
@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include "fixed_dense_grid.hpp"
+#include "grid.bench.hpp"
+
+using namespace ungrd;
+
+// the inputs cover the cells [-4, 28) in every dimension
+using bench_fixed_dense_grid = s32_e32_fixed_dense_grid<64, 64, 64>;
+
+// FirstUpdate
+
+BENCHMARK_TEMPLATE(BMT_Grid_FirstUpdate_DenseCells, bench_fixed_dense_grid)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, DENSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(BMT_Grid_FirstUpdate_RandomCells, bench_fixed_dense_grid)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+// NoChangeUpdate
+
+BENCHMARK_TEMPLATE(BMT_Grid_NoChangeUpdate_DenseCells, bench_fixed_dense_grid)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, DENSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(BMT_Grid_NoChangeUpdate_RandomCells, bench_fixed_dense_grid)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+// CountAllEntries
+
+BENCHMARK_TEMPLATE(BMT_Grid_CountAllEntries_DenseCells, bench_fixed_dense_grid)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, DENSE_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(BMT_Grid_CountAllEntries_RandomCells, bench_fixed_dense_grid)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+// CountEntriesInBox
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_CountEntriesInBox_RandomCells, bench_fixed_dense_grid)
+    ->Ranges(
+        {EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE,
+         BOX_SIDE_RANGE});
+
+// RaysThroughCells
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_RaysThroughCells_RandomCells, bench_fixed_dense_grid)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
+
+BENCHMARK_TEMPLATE(
+    BMT_Grid_RayBatchThroughCells_RandomCells, bench_fixed_dense_grid)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE});
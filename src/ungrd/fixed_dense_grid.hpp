@@ -0,0 +1,373 @@
+#ifndef UNGRD_FIXED_DENSE_GRID_HPP_BCF8A4243EC54ABBBF8600EA81F978AA
+#define UNGRD_FIXED_DENSE_GRID_HPP_BCF8A4243EC54ABBBF8600EA81F978AA
+
+#include "cxx/assert.hpp"
+#include "cxx/dynamic_bitset.hpp"
+#include "cxx/static_lexicographic_indexing.hpp"
+
+#include "entry_cell.hpp"
+#include "entry_policy.hpp"
+#include "entry_tracker.hpp"
+#include "grid_stats.hpp"
+#include "ray_traversal.hpp"
+#include "space_policy.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ungrd {
+
+// A dense grid over a fixed box of cells, described by a
+// static_lexicographic_indexing. The cells are allocated once on construction
+// and never reshaped. Entries at positions outside of the box are ignored.
+template <
+    typename PSpace, typename PEntry, typename TIndexing,
+    typename TAllocator = std::allocator<typename PEntry::entry>>
+class fixed_dense_grid {
+public:
+  using space_policy = PSpace;
+  using entry_policy = PEntry;
+  using indexing_type = TIndexing;
+  using allocator_type = TAllocator;
+
+private:
+  static constexpr std::size_t ndim = space_policy::ndim;
+  using position_type = typename space_policy::position;
+  using position_index_type = typename position_type::value_type;
+  using unsigned_position_index_type =
+      std::make_unsigned_t<position_index_type>;
+
+  static_assert(indexing_type::ndim == ndim);
+  static_assert(
+      not space_policy::periodic, "only dense_grid supports periodic spaces");
+
+  using entry_type = typename entry_policy::entry;
+
+  static_assert(
+      not is_packed_entry_policy<entry_policy>,
+      "only compact_grid supports packed cells");
+
+  using ndidx_type = typename indexing_type::ndidx_type;
+
+  static constexpr bool extents_fit_position_index() {
+    for (size_t dim = 0; dim < ndim; ++dim)
+      if (indexing_type::extent(dim) >
+          size_t(std::numeric_limits<position_index_type>::max()))
+        return false;
+    return true;
+  }
+
+  static_assert(
+      extents_fit_position_index(),
+      "the extents of the box exceed the position index type");
+
+private:
+  using cidx_type = std::size_t;
+
+  using cell_type = entry_cell<entry_policy, allocator_type>;
+
+  using tracker_type = entry_tracker<position_type, entry_type>;
+
+public:
+  // the smallest cell position inside of the box
+  position_type const &origin() const { return origin_; }
+
+  bool contains(position_type const &cpos) const {
+    return indexing_type::contains(cpos_to_ndidx(cpos));
+  }
+
+public:
+  size_t count_filled_cells() const { return stats_.filled_cells; }
+
+  grid_stats<position_type> stats() const {
+    auto stats = stats_;
+    std::tie(stats.lo, stats.hi) = bounding_box();
+    return stats;
+  }
+
+  // the inclusive box of the domain, it contains all filled cells
+  std::pair<position_type, position_type> bounding_box() const {
+    position_type hi;
+    for (size_t dim = 0; dim < ndim; ++dim)
+      hi[dim] = origin_[dim] + static_cast<position_index_type>(
+                                   indexing_type::extent(dim) - 1);
+    return {origin_, hi};
+  }
+
+public:
+  template <typename FCallback>
+  void foreach_entry_at_position(
+      position_type const &cpos, FCallback callback) const {
+    if (auto const cidx = try_cpos_to_cidx(cpos))
+      for (auto const entry : cidx_to_cell_[*cidx].entries())
+        callback(entry);
+  }
+
+  // Calls callback(entry) for every entry in the cells of the box [lo, hi].
+  template <typename FCallback>
+  void foreach_entry_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    foreach_cell_in_box(lo, hi, [&callback](auto const &view) {
+      for (auto const entry : view.entries)
+        callback(entry);
+    });
+  }
+
+  // Calls callback(view) with an entry_cell_view of every filled cell in the
+  // box [lo, hi]. The box is clipped to the domain, which is scanned row by
+  // row.
+  template <typename FCallback>
+  void foreach_cell_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    ndidx_type ndidx_lo, ndidx_hi;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      // the positions of the domain fit into position_index_type
+      auto const domain_hi = static_cast<position_index_type>(
+          origin_[dim] +
+          static_cast<position_index_type>(indexing_type::extent(dim)) - 1);
+      auto const first = std::max(lo[dim], origin_[dim]);
+      auto const last = std::min(hi[dim], domain_hi);
+      if (first > last)
+        return;
+
+      ndidx_lo[dim] = first - origin_[dim];
+      ndidx_hi[dim] = last - origin_[dim] + 1;
+    }
+
+    indexing_type::foreach_ndidx_row(
+        ndidx_lo, ndidx_hi,
+        [this, &callback](
+            ndidx_type const &, cidx_type const first, size_t const length) {
+          filled_cells_.foreach_set_bit_in_range(
+              first, first + length, [this, &callback](cidx_type const cidx) {
+                callback(cidx_to_cell_[cidx].view());
+              });
+        });
+  }
+
+  // Calls callback(cpos, t_enter, t_exit, entries) for every filled cell that
+  // the segment origin + t * direction, t in [0, t_max], passes through, in
+  // order. Coordinates are in units of the cell size, the traversal stops when
+  // the callback returns false. Steps between cells by adding strides to the
+  // cell index.
+  template <typename TReal, typename FCallback>
+  void foreach_cell_along_ray(
+      std::array<TReal, ndim> const &origin,
+      std::array<TReal, ndim> const &direction,
+      std::type_identity_t<TReal> const t_max, FCallback callback) const {
+    auto const [lo, hi] = bounding_box();
+    ray_traversal<position_type, TReal> ray{origin, direction, t_max, lo, hi};
+    if (not ray.valid())
+      return;
+
+    auto cidx = indexing_type::encode(cpos_to_ndidx(ray.cpos()));
+    while (true) {
+      if (filled_cells_.get(cidx) and
+          not callback(
+              ray.cpos(), ray.t_enter(), ray.t_exit(),
+              cidx_to_cell_[cidx].entries()))
+        return;
+
+      if (not ray.step())
+        return;
+
+      auto const stride = indexing_type::stride(ray.step_dim());
+      if (ray.step_sign() > 0)
+        cidx += stride;
+      else
+        cidx -= stride;
+    }
+  }
+
+  template <typename FCallback>
+  void foreach_position(FCallback callback) const {
+    filled_cells_.foreach_set_bit([this, &callback](cidx_type const cidx) {
+      auto const cpos = ndidx_to_cpos(indexing_type::decode(cidx));
+
+      callback(cpos);
+    });
+  }
+
+public:
+  template <typename TInput>
+  void update(TInput const &input) {
+    if (tracker_)
+      tracker_->invalidate();
+
+    filled_cells_.foreach_set_bit([this](cidx_type const cidx) {
+      cidx_to_cell_[cidx].clear_entries();
+    });
+    filled_cells_.reset_all();
+    stats_.clear();
+
+    for (auto const &element : input)
+      add_input_entry(element);
+  }
+
+public:
+  // Updates the grid with the positions of all entries, cposes[entry] is the
+  // cell position of entry. The grid remembers the position of every entry and
+  // only moves the entries whose cell changed. Calling update or
+  // differential_update in between makes the next call rebuild the grid.
+  template <typename TPositions>
+  void tracked_update(TPositions const &cposes)
+    requires std::is_void_v<typename entry_policy::payload>
+  {
+    if (not tracker_)
+      tracker_ = std::make_unique<tracker_type>();
+
+    auto &tracker = *tracker_;
+    if (tracker.track(cposes))
+      differential_update(tracker.fresh(), tracker.stale());
+    else
+      update(tracker.fresh());
+    tracker.validate();
+  }
+
+  template <typename TFresh, typename TStale>
+  void differential_update(TFresh const &fresh, TStale const &stale) {
+    if (tracker_)
+      tracker_->invalidate();
+
+    for (auto const &element : stale) {
+      if (auto const cidx = try_cpos_to_cidx(std::get<0>(element))) {
+        auto &cell = cidx_to_cell_[*cidx];
+        auto const old_size = cell.size();
+        cell.erase_entry(std::get<1>(element));
+        stats_.resize_cell(old_size, cell.size());
+        if (cell.empty())
+          filled_cells_.reset(*cidx);
+      }
+    }
+
+    for (auto const &element : fresh)
+      add_input_entry(element);
+  }
+
+private:
+  template <typename TElement>
+  void add_input_entry(TElement const &element) {
+    if (auto const cidx = try_cpos_to_cidx(std::get<0>(element))) {
+      auto &cell = cidx_to_cell_[*cidx];
+      auto const old_size = cell.size();
+      cell.add_input_entry(element);
+      stats_.resize_cell(old_size, cell.size());
+      filled_cells_.set(*cidx);
+    }
+  }
+
+private:
+  ndidx_type cpos_to_ndidx(position_type const &cpos) const {
+    ndidx_type ndidx;
+    for (size_t dim = 0; dim < ndim; ++dim)
+      ndidx[dim] = static_cast<unsigned_position_index_type>(
+          static_cast<unsigned_position_index_type>(cpos[dim]) -
+          static_cast<unsigned_position_index_type>(origin_[dim]));
+    return ndidx;
+  }
+
+  std::optional<cidx_type> try_cpos_to_cidx(position_type const &cpos) const {
+    return indexing_type::try_encode(cpos_to_ndidx(cpos));
+  }
+
+  position_type ndidx_to_cpos(ndidx_type const &ndidx) const {
+    position_type cpos;
+    for (size_t dim = 0; dim < ndim; ++dim)
+      cpos[dim] = static_cast<position_index_type>(ndidx[dim]) + origin_[dim];
+    return cpos;
+  }
+
+  static constexpr position_type centered_origin() {
+    position_type origin;
+    for (size_t dim = 0; dim < ndim; ++dim)
+      origin[dim] = -static_cast<position_index_type>(
+          indexing_type::extent(dim) / 2);
+    return origin;
+  }
+
+public:
+  allocator_type get_allocator() const { return allocator_; }
+
+  // Empties all cells and frees the memory of their entries.
+  void clear() { *this = fixed_dense_grid{origin_, allocator_}; }
+
+public:
+  fixed_dense_grid() : fixed_dense_grid(centered_origin()) {}
+
+  explicit fixed_dense_grid(allocator_type const &allocator)
+      : fixed_dense_grid(centered_origin(), allocator) {}
+
+  explicit fixed_dense_grid(
+      position_type const &origin, allocator_type const &allocator = {})
+      : allocator_{allocator}, origin_{origin},
+        cidx_to_cell_{make_cells<cell_type>(indexing_type::size(), allocator)},
+        filled_cells_{indexing_type::size()} {
+    using limits = std::numeric_limits<position_index_type>;
+    for (size_t dim = 0; dim < ndim; ++dim)
+      UNGRD_ASSERT(
+          the box fits into the position index type,
+          origin[dim] <= limits::max() - position_index_type(
+                                             indexing_type::extent(dim) - 1));
+  }
+
+  fixed_dense_grid(fixed_dense_grid const &) = delete;
+  fixed_dense_grid &operator=(fixed_dense_grid const &) = delete;
+  fixed_dense_grid(fixed_dense_grid &&) = default;
+
+  // Moves the cells of other into memory from allocator and leaves other
+  // empty.
+  fixed_dense_grid(fixed_dense_grid &&other, allocator_type const &allocator)
+      : allocator_{allocator}, origin_{other.origin_},
+        cidx_to_cell_{move_cells(std::move(other.cidx_to_cell_), allocator)},
+        filled_cells_{std::move(other.filled_cells_)},
+        stats_{std::move(other.stats_)}, tracker_{std::move(other.tracker_)} {
+    other.clear();
+  }
+
+  // Swaps the contents if the allocators compare equal, otherwise moves the
+  // cells.
+  fixed_dense_grid &operator=(fixed_dense_grid &&other) noexcept(
+      std::allocator_traits<allocator_type>::is_always_equal::value) {
+    if (not(allocator_ == other.allocator_))
+      return *this = fixed_dense_grid{std::move(other), allocator_};
+
+    using std::swap;
+    swap(origin_, other.origin_);
+    swap(cidx_to_cell_, other.cidx_to_cell_);
+    swap(filled_cells_, other.filled_cells_);
+    swap(stats_, other.stats_);
+    swap(tracker_, other.tracker_);
+    return *this;
+  }
+
+private:
+  allocator_type allocator_;
+
+  position_type origin_;
+
+  std::vector<cell_type> cidx_to_cell_;
+  dynamic_bitset<> filled_cells_;
+
+  grid_stats<position_type> stats_ = {};
+
+  // allocated by the first tracked_update
+  std::unique_ptr<tracker_type> tracker_ = {};
+};
+
+template <size_t... NExtents>
+using s32_e32_fixed_dense_grid = fixed_dense_grid<
+    s32_space_policy<sizeof...(NExtents)>, u32_entry_policy,
+    static_lexicographic_indexing<NExtents...>>;
+
+} // namespace ungrd
+
+#endif // UNGRD_FIXED_DENSE_GRID_HPP_BCF8A4243EC54ABBBF8600EA81F978AA
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "fixed_dense_grid.hpp"
+#include "grid.tests.hpp"
+#include "slab_memory_resource.hpp"
+
+using namespace ungrd;
+
+TEST(FixedDenseGrid, Correctness) {
+  T_Grid_Correctness<s32_e32_fixed_dense_grid<16, 16, 16>>();
+}
+
+TEST(FixedDenseGrid, SlabMemoryResourceCorrectness) {
+  using grid_type = fixed_dense_grid<
+      s32_space_policy<3>, u32_entry_policy,
+      static_lexicographic_indexing<16, 16, 16>,
+      std::pmr::polymorphic_allocator<u32_entry_policy::entry>>;
+
+  slab_memory_resource resource;
+  T_Grid_Correctness<grid_type>(&resource);
+}
+
+TEST(FixedDenseGrid, SlabMemoryResourceClear) {
+  T_Grid_SlabMemoryResourceClear<fixed_dense_grid<
+      s32_space_policy<3>, u32_entry_policy,
+      static_lexicographic_indexing<16, 16, 16>,
+      std::pmr::polymorphic_allocator<u32_entry_policy::entry>>>();
+}
+
+TEST(FixedDenseGrid, RandomDifferentialUpdates) {
+  T_Grid_RandomDifferentialUpdates<s32_e32_fixed_dense_grid<40, 40, 40>>();
+}
+
+TEST(FixedDenseGrid, BoxQuery) {
+  T_Grid_BoxQuery<s32_e32_fixed_dense_grid<16, 16, 16>>();
+}
+
+TEST(FixedDenseGrid, Payload) {
+  T_Grid_Payload<fixed_dense_grid<
+      s32_space_policy<3>, u32_f32xN_entry_policy<3>,
+      static_lexicographic_indexing<16, 16, 16>>>();
+}
+
+TEST(FixedDenseGrid, TrackedUpdate) {
+  T_Grid_TrackedUpdate<s32_e32_fixed_dense_grid<16, 16, 16>>();
+}
+
+TEST(FixedDenseGrid, S16E16Correctness) {
+  T_Grid_Correctness<fixed_dense_grid<
+      s16_space_policy<3>, u16_entry_policy,
+      static_lexicographic_indexing<16, 16, 16>>>();
+}
+
+TEST(FixedDenseGrid, S16E16BoxQuery) {
+  T_Grid_BoxQuery<fixed_dense_grid<
+      s16_space_policy<3>, u16_entry_policy,
+      static_lexicographic_indexing<16, 16, 16>>>();
+}
+
+TEST(FixedDenseGrid, Domain) {
+  using grid_type = s32_e32_fixed_dense_grid<4, 3>;
+  using position_type = grid_type::space_policy::position;
+
+  {
+    grid_type const grid;
+    ASSERT_EQ((position_type{-2, -1}), grid.origin());
+  }
+
+  grid_type grid{position_type{10, -5}};
+  ASSERT_TRUE(grid.contains({10, -5}));
+  ASSERT_TRUE(grid.contains({13, -3}));
+  ASSERT_FALSE(grid.contains({9, -5}));
+  ASSERT_FALSE(grid.contains({14, -5}));
+  ASSERT_FALSE(grid.contains({10, -6}));
+  ASSERT_FALSE(grid.contains({10, -2}));
+
+  // entries outside of the domain are ignored
+  std::vector<std::pair<position_type, std::uint32_t>> input = {
+      {{10, -5}, 0}, {{13, -3}, 1}, {{14, -3}, 2}, {{-10, 5}, 3}};
+  grid.update(input);
+  ASSERT_EQ(2, grid.count_filled_cells());
+
+  std::vector<std::uint32_t> entries;
+  grid.foreach_entry_at_position(
+      {14, -3}, [&entries](auto const entry) { entries.push_back(entry); });
+  ASSERT_TRUE(entries.empty());
+
+  std::vector<position_type> positions;
+  grid.foreach_position(
+      [&positions](auto const &cpos) { positions.push_back(cpos); });
+  ASSERT_EQ((std::vector<position_type>{{10, -5}, {13, -3}}), positions);
+}
@@ -2,7 +2,12 @@
 #define UNGRD_GRID_BENCH_HPP_A7C1454A8E884C0BBBF465165423A19B
 
 #include "cxx/lexicographic_indexing.hpp"
+#include "ray_traversal.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
 #include <random>
 #include <vector>
 
@@ -154,6 +159,39 @@ void BMT_Grid_SomeMoveOneUpdate(benchmark::State &state, Input &input) {
   state.counters["nfc"] = grid.count_filled_cells();
 }
 
+template <typename Grid, typename Input>
+void BMT_Grid_SomeMoveOneTrackedUpdate(
+    benchmark::State &state, Input const &input) {
+  state.counters["ne"] = input.size();
+
+  using position_type = typename Grid::space_policy::position;
+
+  // the entries of the input are their indices
+  std::vector<position_type> cposes;
+  for (auto const &[cpos, entry] : input)
+    cposes.push_back(cpos);
+
+  Grid grid;
+  grid.tracked_update(cposes);
+
+  constexpr size_t ndim = Grid::space_policy::ndim;
+
+  size_t const move_count = state.range(ndim + 1);
+
+  size_t entry = 0;
+  for (auto _ : state) {
+    for (size_t move = 0; move < move_count; ++move) {
+      for (size_t dim = 0; dim < ndim; ++dim)
+        ++cposes[entry][dim];
+      entry = (entry + 7919) % cposes.size();
+    }
+
+    grid.tracked_update(cposes);
+  }
+
+  state.counters["nfc"] = grid.count_filled_cells();
+}
+
 template <typename Grid, typename Input>
 void BMT_Grid_CountAllEntries(benchmark::State &state, Input const &input) {
   state.counters["ne"] = input.size();
@@ -173,6 +211,127 @@ void BMT_Grid_CountAllEntries(benchmark::State &state, Input const &input) {
   state.counters["nge"] = count;
 }
 
+template <typename Grid, typename Input>
+void BMT_Grid_CountEntriesInBox(benchmark::State &state, Input const &input) {
+  state.counters["ne"] = input.size();
+
+  Grid grid;
+  grid.update(input);
+
+  constexpr size_t ndim = Grid::space_policy::ndim;
+  using position_type = typename Grid::space_policy::position;
+
+  // a box in the corner of the cells of the input
+  auto const side = state.range(ndim + 1);
+  position_type lo, hi;
+  for (size_t dim = 0; dim < ndim; ++dim) {
+    lo[dim] = -4;
+    hi[dim] = -4 + side - 1;
+  }
+
+  size_t count = 0;
+  for (auto _ : state) {
+    count = 0;
+    grid.foreach_entry_in_box(lo, hi, [&count](auto const) { ++count; });
+    benchmark::DoNotOptimize(count);
+  }
+
+  state.counters["nfc"] = grid.count_filled_cells();
+  state.counters["nbe"] = count;
+}
+
+template <typename Grid>
+auto &Grid_RandomRays(benchmark::State &state) {
+  constexpr size_t ndim = Grid::space_policy::ndim;
+  using point_type = std::array<double, ndim>;
+
+  std::mt19937 gen{2};
+  std::normal_distribution<double> direction_dis;
+
+  static struct {
+    std::vector<point_type> origins, directions;
+    std::vector<double> t_maxes;
+  } rays;
+  rays.origins.clear();
+  rays.directions.clear();
+  rays.t_maxes.clear();
+
+  for (size_t ray = 0; ray < 1024; ++ray) {
+    point_type origin, direction;
+    double norm = 0;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      std::uniform_real_distribution<double> origin_dis{
+          -4., state.range(dim) - 4.};
+      origin[dim] = origin_dis(gen);
+      direction[dim] = direction_dis(gen);
+      norm += direction[dim] * direction[dim];
+    }
+    for (size_t dim = 0; dim < ndim; ++dim)
+      direction[dim] /= std::sqrt(norm);
+
+    rays.origins.push_back(origin);
+    rays.directions.push_back(direction);
+    rays.t_maxes.push_back(64.);
+  }
+
+  return rays;
+}
+
+template <typename Grid, typename Input>
+void BMT_Grid_RaysThroughCells(benchmark::State &state, Input const &input) {
+  state.counters["ne"] = input.size();
+
+  Grid grid;
+  grid.update(input);
+
+  auto const &rays = Grid_RandomRays<Grid>(state);
+
+  size_t count = 0;
+  for (auto _ : state) {
+    count = 0;
+    for (size_t ray = 0; ray < rays.origins.size(); ++ray)
+      grid.foreach_cell_along_ray(
+          rays.origins[ray], rays.directions[ray], rays.t_maxes[ray],
+          [&count](auto const &, double, double, auto const &entries) {
+            count += entries.size();
+            return true;
+          });
+  }
+
+  state.counters["nfc"] = grid.count_filled_cells();
+  state.counters["nre"] = count;
+  state.SetItemsProcessed(state.iterations() * rays.origins.size());
+}
+
+template <typename Grid, typename Input>
+void BMT_Grid_RayBatchThroughCells(
+    benchmark::State &state, Input const &input) {
+  state.counters["ne"] = input.size();
+
+  Grid grid;
+  grid.update(input);
+
+  auto const &rays = Grid_RandomRays<Grid>(state);
+
+  std::vector<size_t> counts(rays.origins.size());
+  for (auto _ : state) {
+    std::fill(counts.begin(), counts.end(), 0);
+    foreach_cell_along_rays(
+        grid, rays.origins, rays.directions, rays.t_maxes,
+        [&counts](
+            size_t const ray, auto const &, double, double,
+            auto const &entries) {
+          counts[ray] += entries.size();
+          return true;
+        });
+  }
+
+  state.counters["nfc"] = grid.count_filled_cells();
+  state.counters["nre"] =
+      std::accumulate(counts.begin(), counts.end(), size_t{0});
+  state.SetItemsProcessed(state.iterations() * rays.origins.size());
+}
+
 // FirstUpdate
 
 template <typename Grid>
@@ -229,6 +388,14 @@ void BMT_Grid_SomeMoveOneUpdate_RandomCells(benchmark::State &state) {
   BMT_Grid_SomeMoveOneUpdate<Grid>(state, input);
 }
 
+// SomeMoveOneTrackedUpdate
+
+template <typename Grid>
+void BMT_Grid_SomeMoveOneTrackedUpdate_RandomCells(benchmark::State &state) {
+  auto const &input = Grid_RandomCells_Input<Grid>(state);
+  BMT_Grid_SomeMoveOneTrackedUpdate<Grid>(state, input);
+}
+
 // CountAllEntries
 
 template <typename Grid>
@@ -243,6 +410,28 @@ void BMT_Grid_CountAllEntries_RandomCells(benchmark::State &state) {
   BMT_Grid_CountAllEntries<Grid>(state, input);
 }
 
+// CountEntriesInBox
+
+template <typename Grid>
+void BMT_Grid_CountEntriesInBox_RandomCells(benchmark::State &state) {
+  auto const &input = Grid_RandomCells_Input<Grid>(state);
+  BMT_Grid_CountEntriesInBox<Grid>(state, input);
+}
+
+// RaysThroughCells
+
+template <typename Grid>
+void BMT_Grid_RaysThroughCells_RandomCells(benchmark::State &state) {
+  auto const &input = Grid_RandomCells_Input<Grid>(state);
+  BMT_Grid_RaysThroughCells<Grid>(state, input);
+}
+
+template <typename Grid>
+void BMT_Grid_RayBatchThroughCells_RandomCells(benchmark::State &state) {
+  auto const &input = Grid_RandomCells_Input<Grid>(state);
+  BMT_Grid_RayBatchThroughCells<Grid>(state, input);
+}
+
 #define EXTENT_RANGE                                                           \
   { 32, 32 }
 
@@ -252,6 +441,19 @@ void BMT_Grid_CountAllEntries_RandomCells(benchmark::State &state) {
 #define RANDOM_ENTRY_RANGE                                                     \
   { 32 * 32 * 32, 32 * 32 * 32 * 64 }
 
+#define MOVE_COUNT_RANGE                                                       \
+  { 1024, 32 * 32 * 32 }
+
+#define BOX_SIDE_RANGE                                                         \
+  { 2, 32 }
+
+// 16^3 cells with 16 entries each, 2^16 entries fit into 16-bit entries
+#define NARROW_EXTENT_RANGE                                                    \
+  { 16, 16 }
+
+#define NARROW_DENSE_ENTRY_RANGE                                               \
+  { 16, 16 }
+
 } // namespace ungrd
 
 #endif // UNGRD_GRID_BENCH_HPP_A7C1454A8E884C0BBBF465165423A19B
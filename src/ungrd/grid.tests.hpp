@@ -3,19 +3,28 @@
 
 #include <gtest/gtest.h>
 
+#include "cxx/map.hpp"
 #include "cxx/set.hpp"
 
+#include "slab_memory_resource.hpp"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace ungrd {
 
-template <typename Grid>
-void T_Grid_Correctness() {
+template <typename Grid, typename... TArgs>
+void T_Grid_Correctness(TArgs &&...args) {
   using grid_type = Grid;
   using position_type = typename grid_type::space_policy::position;
   using entry_type = typename grid_type::entry_policy::entry;
 
-  grid_type grid;
+  grid_type grid{std::forward<TArgs>(args)...};
 
   std::vector<std::pair<position_type, entry_type>> input = {
       {{-1, -2, -3}, 5}, {{3, 2, 1}, 2}, {{-1, -2, -3}, 1},
@@ -142,6 +151,392 @@ void T_Grid_Correctness() {
     grid.foreach_entry_at_position({999, 999, 999}, collect_entries);
     ASSERT_EQ(0, entries.size());
   }
+
+  {
+    // a full update replaces all previous cells
+    grid.update(input);
+    ASSERT_EQ(4, grid.count_filled_cells());
+
+    hash_set<position_type> positions;
+    grid.foreach_position([&positions](auto const &position) {
+      positions.insert(position);
+    });
+    ASSERT_EQ(4, positions.size());
+    ASSERT_FALSE(positions.contains({-4, -5, -6}));
+    ASSERT_FALSE(positions.contains({4, 3, 2}));
+  }
+}
+
+// Compares the statistics of grid with the cells of expected, a map from the
+// positions of the filled cells to their entries.
+template <typename Grid, typename TExpected>
+void check_grid_stats(Grid const &grid, TExpected const &expected) {
+  constexpr size_t ndim = Grid::space_policy::ndim;
+
+  auto const stats = grid.stats();
+  using stats_type = std::remove_const_t<decltype(stats)>;
+  ASSERT_EQ(expected.size(), stats.filled_cells);
+
+  size_t entry_count = 0, max_occupancy = 0;
+  std::array<size_t, stats_type::bucket_count> histogram = {};
+  for (auto const &[cpos, entries] : expected) {
+    entry_count += entries.size();
+    max_occupancy = std::max(max_occupancy, entries.size());
+    ++histogram[stats_type::bucket(entries.size())];
+
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      ASSERT_LE(stats.lo[dim], cpos[dim]);
+      ASSERT_LE(cpos[dim], stats.hi[dim]);
+    }
+  }
+  ASSERT_EQ(entry_count, stats.entries);
+  ASSERT_EQ(histogram, stats.occupancy_histogram);
+  ASSERT_LE(max_occupancy, stats.max_occupancy_bound());
+  ASSERT_LE(stats.max_occupancy_bound(), 2 * max_occupancy);
+}
+
+// Applies random differential updates and compares the grid with a reference.
+template <typename Grid, typename... TArgs>
+void T_Grid_RandomDifferentialUpdates(TArgs &&...args) {
+  using grid_type = Grid;
+  using position_type = typename grid_type::space_policy::position;
+  using entry_type = typename grid_type::entry_policy::entry;
+
+  constexpr size_t ndim = grid_type::space_policy::ndim;
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{-6, 6};
+  std::uniform_int_distribution<int> step_dis{-2, 2};
+
+  grid_type grid{std::forward<TArgs>(args)...};
+
+  std::vector<position_type> entry_positions(200);
+  for (auto &cpos : entry_positions)
+    for (size_t dim = 0; dim < ndim; ++dim)
+      cpos[dim] = coordinate_dis(gen);
+
+  {
+    std::vector<std::pair<position_type, entry_type>> input;
+    for (size_t entry = 0; entry < entry_positions.size(); ++entry)
+      input.emplace_back(entry_positions[entry], entry);
+    grid.update(input);
+  }
+
+  auto const check = [&] {
+    hash_map<position_type, hash_set<entry_type>> expected;
+    for (size_t entry = 0; entry < entry_positions.size(); ++entry)
+      expected[entry_positions[entry]].insert(entry);
+
+    ASSERT_EQ(expected.size(), grid.count_filled_cells());
+    check_grid_stats(grid, expected);
+
+    size_t position_count = 0;
+    grid.foreach_position([&](auto const &cpos) {
+      ++position_count;
+      ASSERT_TRUE(expected.contains(cpos));
+
+      hash_set<entry_type> entries;
+      grid.foreach_entry_at_position(
+          cpos, [&entries](auto const entry) { entries.insert(entry); });
+      ASSERT_EQ(expected[cpos], entries);
+    });
+    ASSERT_EQ(expected.size(), position_count);
+  };
+
+  check();
+
+  for (size_t round = 0; round < 20; ++round) {
+    std::vector<std::pair<position_type, entry_type>> fresh, stale;
+    for (size_t entry = 0; entry < entry_positions.size(); ++entry) {
+      if (entry % 4 != round % 4)
+        continue;
+
+      auto &cpos = entry_positions[entry];
+      stale.emplace_back(cpos, entry);
+      for (size_t dim = 0; dim < ndim; ++dim)
+        cpos[dim] += step_dis(gen);
+      fresh.emplace_back(cpos, entry);
+    }
+
+    grid.differential_update(fresh, stale);
+    check();
+  }
+}
+
+// Compares box queries with a brute force search over all entries.
+template <typename Grid, typename... TArgs>
+void T_Grid_BoxQuery(TArgs &&...args) {
+  using grid_type = Grid;
+  using position_type = typename grid_type::space_policy::position;
+  using entry_type = typename grid_type::entry_policy::entry;
+
+  constexpr size_t ndim = grid_type::space_policy::ndim;
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{-6, 6};
+  std::uniform_int_distribution<int> box_dis{-9, 9};
+
+  grid_type grid{std::forward<TArgs>(args)...};
+
+  std::vector<std::pair<position_type, entry_type>> input;
+  for (entry_type entry = 0; entry < 300; ++entry) {
+    position_type cpos;
+    for (size_t dim = 0; dim < ndim; ++dim)
+      cpos[dim] = coordinate_dis(gen);
+    input.emplace_back(cpos, entry);
+  }
+  grid.update(input);
+
+  auto const check = [&](position_type const &lo, position_type const &hi) {
+    std::vector<entry_type> expected;
+    for (auto const &[cpos, entry] : input) {
+      bool inside = true;
+      for (size_t dim = 0; dim < ndim; ++dim)
+        inside = inside and lo[dim] <= cpos[dim] and cpos[dim] <= hi[dim];
+      if (inside)
+        expected.push_back(entry);
+    }
+
+    std::vector<entry_type> entries;
+    grid.foreach_entry_in_box(
+        lo, hi, [&entries](auto const entry) { entries.push_back(entry); });
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(entries.begin(), entries.end());
+    ASSERT_EQ(expected, entries);
+  };
+
+  // a single cell, everything and nothing
+  check(input[0].first, input[0].first);
+  check(
+      grid_type::space_policy::most_negative_position(),
+      grid_type::space_policy::most_positive_position());
+  check(
+      grid_type::space_policy::most_positive_position(),
+      grid_type::space_policy::most_negative_position());
+
+  for (size_t round = 0; round < 200; ++round) {
+    position_type lo, hi;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      lo[dim] = box_dis(gen);
+      hi[dim] = box_dis(gen);
+      // mostly non-empty boxes
+      if (round % 8 != 0 and lo[dim] > hi[dim])
+        std::swap(lo[dim], hi[dim]);
+    }
+    check(lo, hi);
+  }
+}
+
+// Checks that the payloads in the cell views stay aligned with their entries
+// through updates, differential updates and payload replacements.
+template <typename Grid, typename... TArgs>
+void T_Grid_Payload(TArgs &&...args) {
+  using grid_type = Grid;
+  using position_type = typename grid_type::space_policy::position;
+  using entry_type = typename grid_type::entry_policy::entry;
+  using payload_type = typename grid_type::entry_policy::payload;
+  using element_type = std::tuple<position_type, entry_type, payload_type>;
+
+  constexpr size_t ndim = grid_type::space_policy::ndim;
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{-6, 6};
+  std::uniform_int_distribution<int> step_dis{-1, 1};
+
+  grid_type grid{std::forward<TArgs>(args)...};
+
+  std::vector<position_type> entry_positions(200);
+  std::vector<payload_type> entry_payloads(entry_positions.size());
+  for (size_t entry = 0; entry < entry_positions.size(); ++entry) {
+    for (size_t dim = 0; dim < ndim; ++dim)
+      entry_positions[entry][dim] = coordinate_dis(gen);
+    for (size_t component = 0; component < entry_payloads[entry].size();
+         ++component)
+      entry_payloads[entry][component] = entry * 10 + component;
+  }
+
+  {
+    // the last payload of an entry that is added twice wins
+    std::vector<element_type> input;
+    for (size_t entry = 0; entry < entry_positions.size(); ++entry)
+      input.emplace_back(entry_positions[entry], entry, payload_type{});
+    for (size_t entry = 0; entry < entry_positions.size(); ++entry)
+      input.emplace_back(
+          entry_positions[entry], entry, entry_payloads[entry]);
+    grid.update(input);
+  }
+
+  auto const check = [&] {
+    size_t entry_count = 0;
+    grid.foreach_cell_in_box(
+        grid_type::space_policy::most_negative_position(),
+        grid_type::space_policy::most_positive_position(),
+        [&](auto const &view) {
+          ASSERT_GT(view.size(), 0u);
+          for (auto const &components : view.payload)
+            ASSERT_EQ(view.size(), components.size());
+
+          for (size_t index = 0; index < view.size(); ++index) {
+            auto const entry = view.entries[index];
+            ASSERT_LT(entry, entry_payloads.size());
+            for (size_t component = 0; component < view.payload.size();
+                 ++component)
+              ASSERT_EQ(
+                  entry_payloads[entry][component],
+                  view.payload[component][index]);
+          }
+          entry_count += view.size();
+        });
+    ASSERT_EQ(entry_positions.size(), entry_count);
+  };
+
+  check();
+
+  for (size_t round = 0; round < 10; ++round) {
+    std::vector<element_type> fresh, stale;
+    for (size_t entry = 0; entry < entry_positions.size(); ++entry) {
+      if (entry % 3 != round % 3)
+        continue;
+
+      auto &cpos = entry_positions[entry];
+      auto &payload = entry_payloads[entry];
+      stale.emplace_back(cpos, entry, payload);
+      for (size_t dim = 0; dim < ndim; ++dim)
+        cpos[dim] = std::clamp(cpos[dim] + step_dis(gen), -6, 6);
+      for (auto &component : payload)
+        component += 1;
+      fresh.emplace_back(cpos, entry, payload);
+    }
+
+    grid.differential_update(fresh, stale);
+    check();
+  }
+}
+
+// Moves random entries with tracked updates and compares the grid with a
+// reference, also after mixing in plain updates and changing the entry count.
+template <typename Grid, typename... TArgs>
+void T_Grid_TrackedUpdate(TArgs &&...args) {
+  using grid_type = Grid;
+  using position_type = typename grid_type::space_policy::position;
+  using entry_type = typename grid_type::entry_policy::entry;
+
+  constexpr size_t ndim = grid_type::space_policy::ndim;
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{-6, 6};
+  std::uniform_int_distribution<int> step_dis{-1, 1};
+
+  grid_type grid{std::forward<TArgs>(args)...};
+
+  std::vector<position_type> cposes(200);
+  for (auto &cpos : cposes)
+    for (size_t dim = 0; dim < ndim; ++dim)
+      cpos[dim] = coordinate_dis(gen);
+
+  auto const check = [&] {
+    hash_map<position_type, hash_set<entry_type>> expected;
+    for (size_t entry = 0; entry < cposes.size(); ++entry)
+      expected[cposes[entry]].insert(entry);
+
+    ASSERT_EQ(expected.size(), grid.count_filled_cells());
+    check_grid_stats(grid, expected);
+
+    grid.foreach_position([&](auto const &cpos) {
+      ASSERT_TRUE(expected.contains(cpos));
+
+      hash_set<entry_type> entries;
+      grid.foreach_entry_at_position(
+          cpos, [&entries](auto const entry) { entries.insert(entry); });
+      ASSERT_EQ(expected[cpos], entries);
+    });
+  };
+
+  auto const move_some = [&] {
+    for (size_t entry = 0; entry < cposes.size(); ++entry)
+      if (entry % 5 == 0)
+        for (size_t dim = 0; dim < ndim; ++dim)
+          cposes[entry][dim] =
+              std::clamp(cposes[entry][dim] + step_dis(gen), -6, 6);
+  };
+
+  grid.tracked_update(cposes);
+  check();
+
+  for (size_t round = 0; round < 10; ++round) {
+    move_some();
+    grid.tracked_update(cposes);
+    check();
+  }
+
+  // a plain update in between
+  {
+    std::vector<std::pair<position_type, entry_type>> input;
+    for (size_t entry = 0; entry < 50; ++entry)
+      input.emplace_back(position_type{}, entry);
+    grid.update(input);
+  }
+  move_some();
+  grid.tracked_update(cposes);
+  check();
+
+  // fewer entries
+  cposes.resize(120);
+  grid.tracked_update(cposes);
+  check();
+
+  move_some();
+  grid.tracked_update(cposes);
+  check();
+}
+
+// Clears a grid whose cells live in a slab_memory_resource, releases the
+// resource and fills the grid again, then moves it into another grid and into
+// a grid with a different resource.
+template <typename Grid>
+void T_Grid_SlabMemoryResourceClear() {
+  using grid_type = Grid;
+  using position_type = typename grid_type::space_policy::position;
+  using entry_type = typename grid_type::entry_policy::entry;
+
+  static_assert(std::is_move_assignable_v<grid_type>);
+
+  std::vector<std::pair<position_type, entry_type>> input = {
+      {{-1, -2, -3}, 0}, {{3, 2, 1}, 1}, {{-1, -2, -3}, 2}, {{1, 1, 2}, 3}};
+
+  auto const check = [&input](grid_type const &grid) {
+    ASSERT_EQ(3u, grid.count_filled_cells());
+    for (auto const &[cpos, entry] : input) {
+      bool found = false;
+      grid.foreach_entry_at_position(
+          cpos, [&found, entry](auto const other) { found |= other == entry; });
+      ASSERT_TRUE(found);
+    }
+  };
+
+  slab_memory_resource resource;
+  grid_type grid{&resource};
+  grid.update(input);
+  check(grid);
+
+  grid.clear();
+  ASSERT_EQ(0u, grid.count_filled_cells());
+  resource.release();
+
+  grid.update(input);
+  check(grid);
+
+  grid_type other{&resource};
+  other = std::move(grid);
+  check(other);
+
+  // the cells must be moved into the other resource before this one is freed
+  slab_memory_resource other_resource;
+  grid_type elsewhere{&other_resource};
+  elsewhere = std::move(other);
+  resource.release();
+  check(elsewhere);
 }
 
 } // namespace ungrd
@@ -0,0 +1,75 @@
+#ifndef UNGRD_GRID_STATS_HPP_3CFEFF7FBB9F4A74B00744C2C4B86901
+#define UNGRD_GRID_STATS_HPP_3CFEFF7FBB9F4A74B00744C2C4B86901
+
+#include <array>
+#include <bit>
+#include <limits>
+
+#include <cstddef>
+
+namespace ungrd {
+
+// Statistics of the filled cells of a grid. The grids adjust them whenever the
+// size of a cell changes, so reading them does not scan the cells.
+template <typename TPosition>
+struct grid_stats {
+  static constexpr std::size_t bucket_count =
+      std::numeric_limits<std::size_t>::digits + 1;
+
+  // the bucket of the occupancy histogram of a cell with size entries
+  static constexpr std::size_t bucket(std::size_t const size) {
+    return std::bit_width(size);
+  }
+
+  std::size_t filled_cells = 0;
+  std::size_t entries = 0;
+
+  // occupancy_histogram[b] is the number of filled cells with between 2^(b-1)
+  // and 2^b - 1 entries, empty cells are not counted
+  std::array<std::size_t, bucket_count> occupancy_histogram = {};
+
+  // an inclusive box that contains all filled cells, see bounding_box() of the
+  // grid
+  TPosition lo = {};
+  TPosition hi = {};
+
+  // An upper bound on the number of entries in a cell, less than twice the
+  // actual maximum.
+  std::size_t max_occupancy_bound() const {
+    for (std::size_t b = bucket_count - 1; b > 0; --b)
+      if (occupancy_histogram[b] > 0)
+        return std::numeric_limits<std::size_t>::max() >>
+               (bucket_count - 1 - b);
+    return 0;
+  }
+
+  // A cell changed from old_size to new_size entries.
+  void resize_cell(std::size_t const old_size, std::size_t const new_size) {
+    if (old_size == new_size)
+      return;
+
+    if (old_size > 0)
+      --occupancy_histogram[bucket(old_size)];
+    else
+      ++filled_cells;
+
+    if (new_size > 0)
+      ++occupancy_histogram[bucket(new_size)];
+    else
+      --filled_cells;
+
+    entries += new_size;
+    entries -= old_size;
+  }
+
+  // All cells are empty.
+  void clear() {
+    filled_cells = 0;
+    entries = 0;
+    occupancy_histogram.fill(0);
+  }
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_GRID_STATS_HPP_3CFEFF7FBB9F4A74B00744C2C4B86901
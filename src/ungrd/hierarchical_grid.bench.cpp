@@ -0,0 +1,136 @@
+#include <benchmark/benchmark.h>
+
+#include "compact_multi_grid.hpp"
+#include "hierarchical_grid.hpp"
+
+#include <array>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace ungrd;
+
+namespace {
+
+using position_type = std::array<int, 3>;
+using box_type = std::pair<position_type, position_type>;
+
+// Frames of boxes in a region of 256^3 cells whose edges are 1 to range(0)
+// cells long, every box moves by up to a cell per frame.
+auto const &MovingBoxes_Frames(benchmark::State &state) {
+  static std::vector<std::vector<box_type>> frames;
+  static int max_size = 0;
+
+  if (max_size != state.range(0)) {
+    max_size = static_cast<int>(state.range(0));
+
+    std::mt19937 gen{0};
+    std::uniform_int_distribution<int> coordinate_dis{0, 255};
+    std::uniform_int_distribution<int> size_dis{1, max_size};
+    std::uniform_int_distribution<int> step_dis{-1, 1};
+
+    std::vector<box_type> boxes(4096);
+    for (auto &box : boxes) {
+      for (size_t dim = 0; dim < 3; ++dim) {
+        box.first[dim] = coordinate_dis(gen);
+        box.second[dim] = box.first[dim] + size_dis(gen) - 1;
+      }
+    }
+
+    frames.assign(8, boxes);
+    for (size_t frame = 1; frame < frames.size(); ++frame) {
+      for (size_t entry = 0; entry < boxes.size(); ++entry) {
+        for (size_t dim = 0; dim < 3; ++dim) {
+          auto const step = step_dis(gen);
+          frames[frame][entry].first[dim] =
+              frames[frame - 1][entry].first[dim] + step;
+          frames[frame][entry].second[dim] =
+              frames[frame - 1][entry].second[dim] + step;
+        }
+      }
+    }
+  }
+  return frames;
+}
+
+struct MultiGridInput {
+  std::vector<box_type> const *boxes;
+
+  size_t GetEntryCount() const { return boxes->size(); }
+
+  template <typename FCallback>
+  void ForeachEntryPosition(unsigned const entry, FCallback callback) const {
+    auto const &[lo, hi] = (*boxes)[entry];
+    for (int x = lo[0]; x <= hi[0]; ++x)
+      for (int y = lo[1]; y <= hi[1]; ++y)
+        for (int z = lo[2]; z <= hi[2]; ++z)
+          callback(position_type{x, y, z});
+  }
+};
+
+} // namespace
+
+void BM_HierarchicalGrid_MoveBoxes(benchmark::State &state) {
+  auto const &frames = MovingBoxes_Frames(state);
+
+  s32_e32_hierarchical_grid<3> grid;
+  grid.update(frames[0]);
+
+  size_t frame = 0;
+  for (auto _ : state) {
+    frame = (frame + 1) % frames.size();
+    grid.update(frames[frame]);
+  }
+
+  state.SetItemsProcessed(state.iterations() * frames[0].size());
+}
+BENCHMARK(BM_HierarchicalGrid_MoveBoxes)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kMillisecond);
+
+// stores every box in every cell it covers, larger boxes take seconds per frame
+void BM_CompactMultiGrid_MoveBoxes(benchmark::State &state) {
+  auto const &frames = MovingBoxes_Frames(state);
+
+  CompactMultiGrid<unsigned, 3> grid;
+  grid.Update(MultiGridInput{&frames[0]});
+
+  size_t frame = 0;
+  for (auto _ : state) {
+    frame = (frame + 1) % frames.size();
+    grid.Update(MultiGridInput{&frames[frame]});
+  }
+
+  state.SetItemsProcessed(state.iterations() * frames[0].size());
+}
+BENCHMARK(BM_CompactMultiGrid_MoveBoxes)
+    ->Arg(1)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_HierarchicalGrid_BoxQuery(benchmark::State &state) {
+  auto const &frames = MovingBoxes_Frames(state);
+
+  s32_e32_hierarchical_grid<3> grid;
+  grid.update(frames[0]);
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{0, 255};
+
+  size_t found = 0;
+  for (auto _ : state) {
+    position_type lo;
+    for (auto &coordinate : lo)
+      coordinate = coordinate_dis(gen);
+    position_type const hi = {lo[0] + 3, lo[1] + 3, lo[2] + 3};
+
+    grid.foreach_entry_in_box(
+        lo, hi, [&found](auto const entry) { found += entry; });
+  }
+  benchmark::DoNotOptimize(found);
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HierarchicalGrid_BoxQuery)->Arg(1)->Arg(8)->Arg(32);
@@ -0,0 +1,266 @@
+#ifndef UNGRD_HIERARCHICAL_GRID_HPP_8924108F64E04DF68A6D9912530B8433
+#define UNGRD_HIERARCHICAL_GRID_HPP_8924108F64E04DF68A6D9912530B8433
+
+#include "cxx/narrow.hpp"
+
+#include "compact_grid.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ungrd {
+
+// A stack of NLevels grids for entries of widely varying size. The cells of
+// level l are 2^l cells of level 0 wide. An entry is given by the box of level
+// 0 cells it covers and is stored in a single cell, the one of the lower corner
+// of its box at the lowest level whose cells are at least as wide as the box.
+// An update therefore touches one cell per entry, no matter how large it is.
+//
+// The box of an entry reaches at most reach(l) cells beyond its cell in the
+// positive direction, which is 0 at level 0, 1 above and unbounded at the top
+// level, which takes every entry that is too large for the levels below. Box
+// queries visit every level with the box scaled down to its cells and widened
+// by that reach. They return every entry once, a superset of the entries whose
+// boxes intersect the query box.
+template <typename TGrid, std::size_t NLevels>
+class hierarchical_grid {
+  static_assert(NLevels >= 1);
+
+public:
+  using grid_type = TGrid;
+  using space_policy = typename grid_type::space_policy;
+  using entry_policy = typename grid_type::entry_policy;
+
+private:
+  static constexpr std::size_t ndim = space_policy::ndim;
+  using position_type = typename space_policy::position;
+  using position_index_type = typename position_type::value_type;
+
+  using entry_type = typename entry_policy::entry;
+
+  static_assert(std::is_signed_v<position_index_type>);
+  static_assert(
+      std::is_void_v<typename entry_policy::payload>,
+      "payloads would have to be updated for entries that keep their cell");
+  static_assert(
+      not space_policy::periodic, "the levels would wrap at different cells");
+
+public:
+  static constexpr std::size_t level_count() { return NLevels; }
+
+  grid_type const &level(std::size_t const l) const { return levels_[l]; }
+
+  // the number of cells by which the boxes of the entries at level l reach
+  // beyond their cells
+  position_index_type reach(std::size_t const l) const { return reaches_[l]; }
+
+  // the number of entries that changed cells in the last update
+  std::size_t move_count() const { return move_count_; }
+
+  // the level and the cell that entry is stored in
+  std::pair<std::size_t, position_type>
+  entry_position(entry_type const entry) const {
+    return {entry_levels_[entry], entry_cposes_[entry]};
+  }
+
+  // The level at which an entry with the box [lo, hi] of level 0 cells is
+  // stored.
+  static std::size_t
+  box_level(position_type const &lo, position_type const &hi) {
+    std::uint64_t extent = 1;
+    for (std::size_t dim = 0; dim < ndim; ++dim) {
+      auto const span = static_cast<std::uint64_t>(
+          static_cast<std::int64_t>(hi[dim]) - lo[dim]);
+      extent = std::max(extent, span + 1);
+    }
+    return std::min<std::size_t>(std::bit_width(extent - 1), NLevels - 1);
+  }
+
+public:
+  // Calls callback(entry) for every entry whose box may intersect the box
+  // [lo, hi] of level 0 cells.
+  template <typename FCallback>
+  void foreach_entry_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    for (std::size_t dim = 0; dim < ndim; ++dim)
+      if (lo[dim] > hi[dim])
+        return;
+
+    for (std::size_t l = 0; l < NLevels; ++l) {
+      if (level_entry_counts_[l] == 0)
+        continue;
+
+      position_type level_lo, level_hi;
+      for (std::size_t dim = 0; dim < ndim; ++dim) {
+        level_lo[dim] = saturated_sub(lo[dim] >> l, reaches_[l], dim);
+        level_hi[dim] = hi[dim] >> l;
+      }
+      levels_[l].foreach_entry_in_box(level_lo, level_hi, callback);
+    }
+  }
+
+  // Calls callback(entry) for every entry whose box may contain the level 0
+  // cell cpos.
+  template <typename FCallback>
+  void foreach_entry_at_position(
+      position_type const &cpos, FCallback callback) const {
+    foreach_entry_in_box(cpos, cpos, std::move(callback));
+  }
+
+public:
+  // Updates the grid with the boxes of the entries 0, 1, ..., size(boxes)-1.
+  // Every box is given by its lower and upper level 0 cell, accessed with
+  // std::get<0> and std::get<1>. Only the entries that changed levels or cells
+  // are moved, unless the number of entries changed, which rebuilds the grid.
+  template <typename TBoxes>
+  void update(TBoxes const &boxes) {
+    using std::size;
+    std::size_t const entry_count = size(boxes);
+
+    if (entry_count != entry_cposes_.size()) {
+      rebuild(boxes);
+      return;
+    }
+
+    for (std::size_t l = 0; l < NLevels; ++l) {
+      fresh_[l].clear();
+      stale_[l].clear();
+    }
+
+    move_count_ = 0;
+    for (std::size_t entry = 0; entry < entry_count; ++entry) {
+      auto const &lo = std::get<0>(boxes[entry]);
+      auto const &hi = std::get<1>(boxes[entry]);
+
+      auto const l = box_level(lo, hi);
+      auto const cpos = level_cpos(lo, l);
+      grow_reach(lo, hi, l);
+
+      auto &old_l = entry_levels_[entry];
+      auto &old_cpos = entry_cposes_[entry];
+      if (l == old_l and cpos == old_cpos)
+        continue;
+
+      stale_[old_l].emplace_back(old_cpos, narrow<entry_type>(entry));
+      fresh_[l].emplace_back(cpos, narrow<entry_type>(entry));
+      --level_entry_counts_[old_l];
+      ++level_entry_counts_[l];
+
+      old_l = static_cast<std::uint8_t>(l);
+      old_cpos = cpos;
+      ++move_count_;
+    }
+
+    for (std::size_t l = 0; l < NLevels; ++l)
+      if (not fresh_[l].empty() or not stale_[l].empty())
+        levels_[l].differential_update(fresh_[l], stale_[l]);
+  }
+
+  // Rebuilds every level, every entry is put into the cell of its box.
+  template <typename TBoxes>
+  void rebuild(TBoxes const &boxes) {
+    using std::size;
+    std::size_t const entry_count = size(boxes);
+
+    entry_levels_.resize(entry_count);
+    entry_cposes_.resize(entry_count);
+    for (std::size_t l = 0; l < NLevels; ++l) {
+      fresh_[l].clear();
+      reaches_[l] = 0;
+    }
+
+    for (std::size_t entry = 0; entry < entry_count; ++entry) {
+      auto const &lo = std::get<0>(boxes[entry]);
+      auto const &hi = std::get<1>(boxes[entry]);
+
+      auto const l = box_level(lo, hi);
+      auto const cpos = level_cpos(lo, l);
+
+      entry_levels_[entry] = static_cast<std::uint8_t>(l);
+      entry_cposes_[entry] = cpos;
+      fresh_[l].emplace_back(cpos, narrow<entry_type>(entry));
+      grow_reach(lo, hi, l);
+    }
+
+    for (std::size_t l = 0; l < NLevels; ++l) {
+      level_entry_counts_[l] = fresh_[l].size();
+      levels_[l].update(fresh_[l]);
+    }
+    move_count_ = entry_count;
+  }
+
+private:
+  static position_type
+  level_cpos(position_type const &lo, std::size_t const l) {
+    position_type cpos;
+    for (std::size_t dim = 0; dim < ndim; ++dim)
+      cpos[dim] = lo[dim] >> l;
+    return cpos;
+  }
+
+  // the reach of a level only grows until the next rebuild, boxes that shrink
+  // or leave the level do not lower it
+  void grow_reach(
+      position_type const &lo, position_type const &hi, std::size_t const l) {
+    for (std::size_t dim = 0; dim < ndim; ++dim)
+      reaches_[l] = std::max<position_index_type>(
+          reaches_[l], (hi[dim] >> l) - (lo[dim] >> l));
+  }
+
+  // the levels are constructed in place, grids whose allocators cannot be
+  // assigned are only move assignable from grids with equal allocators
+  template <std::size_t... ILevel, typename... TArgs>
+  static std::array<grid_type, NLevels>
+  make_levels(std::index_sequence<ILevel...>, TArgs const &...args) {
+    return {((void) ILevel, grid_type{args...})...};
+  }
+
+  static position_index_type saturated_sub(
+      position_index_type const value, position_index_type const cells,
+      std::size_t const dim) {
+    auto const most_negative = space_policy::most_negative_position()[dim];
+    return value < most_negative + cells ? most_negative : value - cells;
+  }
+
+public:
+  // constructs every level with args, e.g. an allocator
+  template <typename... TArgs>
+  explicit hierarchical_grid(TArgs const &...args)
+      : levels_{make_levels(std::make_index_sequence<NLevels>{}, args...)} {}
+
+  hierarchical_grid(hierarchical_grid const &) = delete;
+  hierarchical_grid &operator=(hierarchical_grid const &) = delete;
+  hierarchical_grid(hierarchical_grid &&) = default;
+  hierarchical_grid &operator=(hierarchical_grid &&) = default;
+
+private:
+  std::array<grid_type, NLevels> levels_ = {};
+  std::array<position_index_type, NLevels> reaches_ = {};
+  std::array<std::size_t, NLevels> level_entry_counts_ = {};
+
+  std::vector<std::uint8_t> entry_levels_ = {};
+  std::vector<position_type> entry_cposes_ = {};
+  std::size_t move_count_ = 0;
+
+  std::array<std::vector<std::pair<position_type, entry_type>>, NLevels>
+      fresh_ = {};
+  std::array<std::vector<std::pair<position_type, entry_type>>, NLevels>
+      stale_ = {};
+};
+
+template <std::size_t NDim, std::size_t NLevels = 8>
+using s32_e32_hierarchical_grid =
+    hierarchical_grid<s32_e32_compact_grid<NDim>, NLevels>;
+
+} // namespace ungrd
+
+#endif // UNGRD_HIERARCHICAL_GRID_HPP_8924108F64E04DF68A6D9912530B8433
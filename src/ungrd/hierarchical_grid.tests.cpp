@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include "dense_grid.hpp"
+#include "hierarchical_grid.hpp"
+#include "slab_memory_resource.hpp"
+
+#include "cxx/map.hpp"
+
+#include <array>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace ungrd;
+
+namespace {
+
+using position_type = std::array<int, 3>;
+using box_type = std::pair<position_type, position_type>;
+
+// Moves and resizes boxes of widely varying size and checks that every entry
+// is stored once and that box queries find every entry whose box intersects
+// the query box, exactly once.
+template <typename Grid, typename... TArgs>
+void T_HierarchicalGrid_Boxes(TArgs &&...args) {
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{-100, 100};
+  std::uniform_int_distribution<int> size_exponent_dis{0, 9};
+  std::uniform_int_distribution<int> step_dis{-3, 3};
+
+  auto const random_box = [&] {
+    box_type box;
+    for (size_t dim = 0; dim < 3; ++dim) {
+      box.first[dim] = coordinate_dis(gen);
+      auto const size = std::uniform_int_distribution<int>{
+          1, 1 << size_exponent_dis(gen)}(gen);
+      box.second[dim] = box.first[dim] + size - 1;
+    }
+    return box;
+  };
+
+  std::vector<box_type> boxes(400);
+  for (auto &box : boxes)
+    box = random_box();
+
+  Grid grid{std::forward<TArgs>(args)...};
+
+  auto const check = [&] {
+    std::vector<size_t> counts(boxes.size());
+    for (size_t l = 0; l < grid.level_count(); ++l) {
+      grid.level(l).foreach_position([&](auto const &cpos) {
+        grid.level(l).foreach_entry_at_position(cpos, [&](auto const entry) {
+          ++counts[entry];
+          ASSERT_EQ(std::make_pair(l, cpos), grid.entry_position(entry));
+          ASSERT_EQ(
+              Grid::box_level(boxes[entry].first, boxes[entry].second), l);
+        });
+      });
+    }
+    for (auto const count : counts)
+      ASSERT_EQ(1u, count);
+
+    for (size_t round = 0; round < 40; ++round) {
+      auto const query = random_box();
+
+      hash_map<std::uint32_t, size_t> found;
+      grid.foreach_entry_in_box(
+          query.first, query.second,
+          [&found](auto const entry) { ++found[entry]; });
+
+      for (auto const &[entry, count] : found)
+        ASSERT_EQ(1u, count);
+
+      for (std::uint32_t entry = 0; entry < boxes.size(); ++entry) {
+        bool intersects = true;
+        for (size_t dim = 0; dim < 3; ++dim)
+          intersects = intersects and
+                       boxes[entry].first[dim] <= query.second[dim] and
+                       query.first[dim] <= boxes[entry].second[dim];
+        if (intersects) {
+          ASSERT_TRUE(found.contains(entry));
+        }
+      }
+    }
+  };
+
+  grid.update(boxes);
+  ASSERT_EQ(boxes.size(), grid.move_count());
+  check();
+
+  for (size_t frame = 0; frame < 10; ++frame) {
+    for (auto &box : boxes) {
+      for (size_t dim = 0; dim < 3; ++dim) {
+        box.first[dim] += step_dis(gen);
+        box.second[dim] =
+            std::max(box.first[dim], box.second[dim] + step_dis(gen));
+      }
+    }
+    grid.update(boxes);
+    ASSERT_LE(grid.move_count(), boxes.size());
+    check();
+  }
+
+  boxes.resize(100);
+  grid.update(boxes);
+  ASSERT_EQ(boxes.size(), grid.move_count());
+  check();
+}
+
+} // namespace
+
+TEST(HierarchicalGrid, Levels) {
+  using grid_type = s32_e32_hierarchical_grid<3, 4>;
+  ASSERT_EQ(0u, grid_type::box_level({0, 0, 0}, {0, 0, 0}));
+  ASSERT_EQ(1u, grid_type::box_level({0, 0, 0}, {0, 1, 0}));
+  ASSERT_EQ(2u, grid_type::box_level({-5, 0, 0}, {-2, 2, 0}));
+  ASSERT_EQ(3u, grid_type::box_level({0, 0, 0}, {0, 0, 4}));
+  ASSERT_EQ(3u, grid_type::box_level({0, 0, 0}, {0, 0, 1000}));
+
+  grid_type grid;
+  std::vector<box_type> boxes = {
+      {{-1, -1, -1}, {-1, -1, -1}}, {{-5, 0, 0}, {-2, 2, 0}}};
+  grid.update(boxes);
+  ASSERT_EQ(std::make_pair(size_t{0}, position_type{-1, -1, -1}),
+            grid.entry_position(0));
+  ASSERT_EQ(std::make_pair(size_t{2}, position_type{-2, 0, 0}),
+            grid.entry_position(1));
+
+  // moving inside the cell of its level does not move an entry
+  boxes[1] = {{-8, 1, 1}, {-5, 3, 3}};
+  grid.update(boxes);
+  ASSERT_EQ(0u, grid.move_count());
+
+  boxes[1] = {{-9, 1, 1}, {-6, 3, 3}};
+  grid.update(boxes);
+  ASSERT_EQ(1u, grid.move_count());
+}
+
+TEST(HierarchicalGrid, CompactBoxes) {
+  T_HierarchicalGrid_Boxes<s32_e32_hierarchical_grid<3, 6>>();
+}
+
+TEST(HierarchicalGrid, DenseBoxes) {
+  T_HierarchicalGrid_Boxes<hierarchical_grid<s32_e32_dense_grid<3>, 6>>();
+}
+
+TEST(HierarchicalGrid, SlabMemoryResourceBoxes) {
+  slab_memory_resource resource;
+  T_HierarchicalGrid_Boxes<hierarchical_grid<s32_e32_pmr_compact_grid<3>, 6>>(
+      &resource);
+}
@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "knn.hpp"
+
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace ungrd;
+
+namespace {
+
+using point_type = std::array<float, 3>;
+
+float point_distance(point_type const &a, point_type const &b) {
+  float sum = 0;
+  for (size_t dim = 0; dim < 3; ++dim)
+    sum += (a[dim] - b[dim]) * (a[dim] - b[dim]);
+  return std::sqrt(sum);
+}
+
+template <typename TPosition>
+TPosition point_to_cpos(point_type const &point) {
+  TPosition cpos;
+  for (size_t dim = 0; dim < 3; ++dim)
+    cpos[dim] = static_cast<typename TPosition::value_type>(
+        std::floor(point[dim]));
+  return cpos;
+}
+
+// uniformly random points in a box of 32^3 cells, with the given number of
+// points per cell on average
+std::vector<point_type> random_points(size_t const points_per_cell) {
+  std::mt19937 gen{0};
+  std::uniform_real_distribution<float> dis{0.f, 32.f};
+
+  std::vector<point_type> points(32 * 32 * 32 * points_per_cell);
+  for (auto &point : points)
+    for (auto &coordinate : point)
+      coordinate = dis(gen);
+  return points;
+}
+
+} // namespace
+
+template <typename Grid>
+void BMT_Knn_Single(benchmark::State &state) {
+  using position_type = typename Grid::space_policy::position;
+  using entry_type = typename Grid::entry_policy::entry;
+
+  auto const points = random_points(state.range(0));
+  size_t const k = state.range(1);
+
+  Grid grid;
+  {
+    std::vector<std::pair<position_type, entry_type>> input;
+    for (entry_type entry = 0; entry < points.size(); ++entry)
+      input.emplace_back(point_to_cpos<position_type>(points[entry]), entry);
+    grid.update(input);
+  }
+
+  std::vector<entry_type> neighbours;
+  neighbours.reserve(k);
+
+  size_t query = 0;
+  for (auto _ : state) {
+    auto const &point = points[query];
+    neighbours.clear();
+    knn(grid, point_to_cpos<position_type>(point), k,
+        [&points, &point](entry_type const entry) {
+          return point_distance(point, points[entry]);
+        },
+        std::back_inserter(neighbours));
+    benchmark::DoNotOptimize(neighbours.data());
+
+    query = (query + 7919) % points.size();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BMT_Knn_Single, s32_e32_dense_grid<3>)
+    ->ArgsProduct({{1, 8}, {8, 64}});
+BENCHMARK_TEMPLATE(BMT_Knn_Single, s32_e32_compact_grid<3>)
+    ->ArgsProduct({{1, 8}, {8, 64}});
+
+template <typename Grid>
+void BMT_Knn_Batch(benchmark::State &state) {
+  using position_type = typename Grid::space_policy::position;
+  using entry_type = typename Grid::entry_policy::entry;
+
+  auto const points = random_points(state.range(0));
+  size_t const k = state.range(1);
+
+  Grid grid;
+  std::vector<position_type> cposes;
+  {
+    std::vector<std::pair<position_type, entry_type>> input;
+    for (entry_type entry = 0; entry < points.size(); ++entry) {
+      cposes.push_back(point_to_cpos<position_type>(points[entry]));
+      input.emplace_back(cposes.back(), entry);
+    }
+    grid.update(input);
+  }
+
+  std::vector<entry_type> neighbours;
+  std::vector<size_t> neighbour_counts;
+
+  for (auto _ : state) {
+    knn_batch(
+        grid, cposes, k,
+        [&points](size_t const query, entry_type const entry) {
+          return point_distance(points[query], points[entry]);
+        },
+        neighbours, neighbour_counts);
+    benchmark::DoNotOptimize(neighbours.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK_TEMPLATE(BMT_Knn_Batch, s32_e32_dense_grid<3>)
+    ->ArgsProduct({{1}, {8, 64}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BMT_Knn_Batch, s32_e32_compact_grid<3>)
+    ->ArgsProduct({{1}, {8, 64}})
+    ->Unit(benchmark::kMillisecond);
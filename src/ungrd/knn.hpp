@@ -0,0 +1,206 @@
+#ifndef UNGRD_KNN_HPP_B43F148CFEFC4EC5A0764CCEF972A1D6
+#define UNGRD_KNN_HPP_B43F148CFEFC4EC5A0764CCEF972A1D6
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ungrd {
+
+// Calls callback(lo, hi) with disjoint inclusive boxes that together cover the
+// cells at Chebyshev distance radius of cpos, clipped to [bounds_lo,
+// bounds_hi]. Every shell is split into two slabs per dimension.
+template <typename TPosition, typename FCallback>
+void foreach_shell_box(
+    TPosition const &cpos, size_t const radius, TPosition const &bounds_lo,
+    TPosition const &bounds_hi, FCallback callback) {
+  constexpr size_t ndim = std::tuple_size_v<TPosition>;
+  using position_index_type = typename TPosition::value_type;
+
+  // in 64 bits, so that cpos +- radius does not overflow 32-bit positions
+  using wide_position_type = std::array<std::int64_t, ndim>;
+  auto const r = static_cast<std::int64_t>(radius);
+
+  auto const clip_and_call = [&](wide_position_type const &lo,
+                                 wide_position_type const &hi) {
+    TPosition box_lo, box_hi;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      auto const first = std::max<std::int64_t>(lo[dim], bounds_lo[dim]);
+      auto const last = std::min<std::int64_t>(hi[dim], bounds_hi[dim]);
+      if (first > last)
+        return;
+
+      box_lo[dim] = static_cast<position_index_type>(first);
+      box_hi[dim] = static_cast<position_index_type>(last);
+    }
+    callback(box_lo, box_hi);
+  };
+
+  wide_position_type lo, hi;
+
+  if (radius == 0) {
+    for (size_t dim = 0; dim < ndim; ++dim)
+      lo[dim] = hi[dim] = cpos[dim];
+    clip_and_call(lo, hi);
+    return;
+  }
+
+  for (size_t slab_dim = 0; slab_dim < ndim; ++slab_dim) {
+    // the slabs of earlier dimensions already cover their boundary cells
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      auto const extent = dim < slab_dim ? r - 1 : r;
+      lo[dim] = cpos[dim] - extent;
+      hi[dim] = cpos[dim] + extent;
+    }
+
+    lo[slab_dim] = hi[slab_dim] = cpos[slab_dim] - r;
+    clip_and_call(lo, hi);
+
+    lo[slab_dim] = hi[slab_dim] = cpos[slab_dim] + r;
+    clip_and_call(lo, hi);
+  }
+}
+
+// Finds the k entries of grid that are closest to a query point in the cell
+// cpos. distance(entry) returns the distance of an entry to the query point in
+// units of the cell size, so entries in cells at Chebyshev distance r of cpos
+// are at least r - 1 away. Only the cells within bounds are visited.
+//
+// The cells are visited in shells of increasing Chebyshev radius, keeping the
+// closest entries in a bounded max-heap. The search stops once the heap is full
+// and the next shell cannot contain a closer entry. On return candidates holds
+// pairs of distance and entry in order of increasing distance.
+template <
+    typename TGrid, typename TPosition, typename FDistance,
+    typename TCandidates>
+void knn_search(
+    TGrid const &grid, std::pair<TPosition, TPosition> const &bounds,
+    TPosition const &cpos, size_t const k, FDistance &&distance,
+    TCandidates &candidates) {
+  constexpr size_t ndim = TGrid::space_policy::ndim;
+
+  static_assert(
+      not TGrid::space_policy::periodic,
+      "shells are clipped to the stored box instead of wrapping");
+
+  using candidate_type = typename TCandidates::value_type;
+  using distance_type = typename candidate_type::first_type;
+
+  candidates.clear();
+  if (k == 0)
+    return;
+
+  auto const &[lo, hi] = bounds;
+
+  // the shell radius that covers all cells within bounds
+  std::int64_t max_radius = 0;
+  for (size_t dim = 0; dim < ndim; ++dim) {
+    if (lo[dim] > hi[dim])
+      return;
+
+    max_radius = std::max<std::int64_t>(
+        {max_radius, std::int64_t{cpos[dim]} - lo[dim],
+         std::int64_t{hi[dim]} - cpos[dim]});
+  }
+
+  auto const consider = [&candidates, k, &distance](auto const entry) {
+    candidate_type candidate{distance(entry), entry};
+    if (candidates.size() < k) {
+      candidates.push_back(candidate);
+      std::push_heap(candidates.begin(), candidates.end());
+    } else if (candidate < candidates.front()) {
+      std::pop_heap(candidates.begin(), candidates.end());
+      candidates.back() = candidate;
+      std::push_heap(candidates.begin(), candidates.end());
+    }
+  };
+
+  for (std::int64_t radius = 0; radius <= max_radius; ++radius) {
+    if (candidates.size() == k and
+        not(static_cast<distance_type>(radius - 1) <
+            candidates.front().first))
+      break;
+
+    foreach_shell_box(
+        cpos, radius, lo, hi,
+        [&grid, &consider](TPosition const &box_lo, TPosition const &box_hi) {
+          grid.foreach_entry_in_box(box_lo, box_hi, consider);
+        });
+  }
+
+  std::sort_heap(candidates.begin(), candidates.end());
+}
+
+// Writes the k entries of grid closest to a query point in the cell cpos to
+// out, in order of increasing distance, see knn_search.
+template <typename TGrid, typename FDistance, typename OutputIt>
+OutputIt knn(
+    TGrid const &grid, typename TGrid::space_policy::position const &cpos,
+    size_t const k, FDistance distance, OutputIt out) {
+  using entry_type = typename TGrid::entry_policy::entry;
+  using distance_type =
+      std::decay_t<std::invoke_result_t<FDistance &, entry_type>>;
+
+  std::vector<std::pair<distance_type, entry_type>> candidates;
+  candidates.reserve(k);
+
+  knn_search(grid, grid.bounding_box(), cpos, k, distance, candidates);
+
+  for (auto const &[entry_distance, entry] : candidates)
+    *(out++) = entry;
+  return out;
+}
+
+// Runs knn for every position of cposes in parallel. distance(query, entry)
+// returns the distance of an entry to the query point of cposes[query]. The
+// neighbours of a query are stored in order of increasing distance in
+// neighbours[query * k, query * k + neighbour_counts[query]).
+template <
+    typename TGrid, typename TPositions, typename FDistance,
+    typename TNeighbours, typename TNeighbourCounts>
+void knn_batch(
+    TGrid const &grid, TPositions const &cposes, size_t const k,
+    FDistance distance, TNeighbours &neighbours,
+    TNeighbourCounts &neighbour_counts) {
+  using entry_type = typename TGrid::entry_policy::entry;
+  using distance_type =
+      std::decay_t<std::invoke_result_t<FDistance &, size_t, entry_type>>;
+
+  using std::size;
+  size_t const query_count = size(cposes);
+
+  neighbours.resize(query_count * k);
+  neighbour_counts.resize(query_count);
+
+  auto const bounds = grid.bounding_box();
+
+#pragma omp parallel
+  {
+    std::vector<std::pair<distance_type, entry_type>> candidates;
+    candidates.reserve(k);
+
+#pragma omp for schedule(dynamic, 64)
+    for (size_t query = 0; query < query_count; ++query) {
+      knn_search(
+          grid, bounds, cposes[query], k,
+          [&distance, query](entry_type const entry) {
+            return distance(query, entry);
+          },
+          candidates);
+
+      neighbour_counts[query] = candidates.size();
+      for (size_t rank = 0; rank < candidates.size(); ++rank)
+        neighbours[query * k + rank] = candidates[rank].second;
+    }
+  }
+}
+
+} // namespace ungrd
+
+#endif // UNGRD_KNN_HPP_B43F148CFEFC4EC5A0764CCEF972A1D6
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "fixed_dense_grid.hpp"
+#include "knn.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace ungrd;
+
+namespace {
+
+using point_type = std::array<double, 3>;
+
+double point_distance(point_type const &a, point_type const &b) {
+  double sum = 0;
+  for (size_t dim = 0; dim < 3; ++dim)
+    sum += (a[dim] - b[dim]) * (a[dim] - b[dim]);
+  return std::sqrt(sum);
+}
+
+template <typename TPosition>
+TPosition point_to_cpos(point_type const &point) {
+  TPosition cpos;
+  for (size_t dim = 0; dim < 3; ++dim)
+    cpos[dim] = static_cast<typename TPosition::value_type>(
+        std::floor(point[dim]));
+  return cpos;
+}
+
+template <typename Grid>
+void T_Grid_Knn() {
+  using position_type = typename Grid::space_policy::position;
+  using entry_type = typename Grid::entry_policy::entry;
+
+  std::mt19937 gen{0};
+  std::uniform_real_distribution<double> point_dis{-6., 6.};
+  std::uniform_real_distribution<double> query_dis{-10., 10.};
+
+  // points in units of the cell size
+  std::vector<point_type> points(500);
+  for (auto &point : points)
+    for (auto &coordinate : point)
+      coordinate = point_dis(gen);
+
+  Grid grid;
+  {
+    std::vector<std::pair<position_type, entry_type>> input;
+    for (entry_type entry = 0; entry < points.size(); ++entry)
+      input.emplace_back(point_to_cpos<position_type>(points[entry]), entry);
+    grid.update(input);
+  }
+
+  std::vector<point_type> queries(100);
+  for (auto &query : queries)
+    for (auto &coordinate : query)
+      coordinate = query_dis(gen);
+
+  auto const expected_knn = [&points](point_type const &query, size_t k) {
+    std::vector<std::pair<double, entry_type>> candidates;
+    for (entry_type entry = 0; entry < points.size(); ++entry)
+      candidates.emplace_back(point_distance(query, points[entry]), entry);
+    std::sort(candidates.begin(), candidates.end());
+    candidates.resize(std::min(k, candidates.size()));
+
+    std::vector<entry_type> entries;
+    for (auto const &[distance, entry] : candidates)
+      entries.push_back(entry);
+    return entries;
+  };
+
+  for (size_t const k : {0, 1, 8, 64, 1000}) {
+    for (auto const &query : queries) {
+      std::vector<entry_type> entries;
+      knn(grid, point_to_cpos<position_type>(query), k,
+          [&query, &points](entry_type const entry) {
+            return point_distance(query, points[entry]);
+          },
+          std::back_inserter(entries));
+      ASSERT_EQ(expected_knn(query, k), entries);
+    }
+
+    std::vector<position_type> query_cposes;
+    for (auto const &query : queries)
+      query_cposes.push_back(point_to_cpos<position_type>(query));
+
+    std::vector<entry_type> neighbours;
+    std::vector<size_t> neighbour_counts;
+    knn_batch(
+        grid, query_cposes, k,
+        [&queries, &points](size_t const query, entry_type const entry) {
+          return point_distance(queries[query], points[entry]);
+        },
+        neighbours, neighbour_counts);
+
+    ASSERT_EQ(queries.size(), neighbour_counts.size());
+    for (size_t query = 0; query < queries.size(); ++query) {
+      auto const first = neighbours.begin() + query * k;
+      ASSERT_EQ(
+          expected_knn(queries[query], k),
+          std::vector<entry_type>(first, first + neighbour_counts[query]));
+    }
+  }
+}
+
+} // namespace
+
+TEST(Knn, ShellBoxesPartitionShells) {
+  using position_type = std::array<int, 3>;
+
+  position_type const cpos{1, -2, 3};
+  position_type const lo{-100, -100, -100}, hi{100, 100, 100};
+
+  for (size_t radius = 0; radius < 5; ++radius) {
+    std::vector<position_type> cells;
+    foreach_shell_box(
+        cpos, radius, lo, hi,
+        [&cells](position_type const &box_lo, position_type const &box_hi) {
+          for (int i = box_lo[0]; i <= box_hi[0]; ++i)
+            for (int j = box_lo[1]; j <= box_hi[1]; ++j)
+              for (int k = box_lo[2]; k <= box_hi[2]; ++k)
+                cells.push_back({i, j, k});
+        });
+
+    std::vector<position_type> expected;
+    int const r = radius;
+    for (int i = -r; i <= r; ++i)
+      for (int j = -r; j <= r; ++j)
+        for (int k = -r; k <= r; ++k)
+          if (std::max({std::abs(i), std::abs(j), std::abs(k)}) == r)
+            expected.push_back({cpos[0] + i, cpos[1] + j, cpos[2] + k});
+
+    std::sort(cells.begin(), cells.end());
+    ASSERT_EQ(expected, cells);
+  }
+}
+
+TEST(Knn, DenseGrid) { T_Grid_Knn<s32_e32_dense_grid<3>>(); }
+
+TEST(Knn, FixedDenseGrid) {
+  T_Grid_Knn<s32_e32_fixed_dense_grid<16, 16, 16>>();
+}
+
+TEST(Knn, CompactGrid) { T_Grid_Knn<s32_e32_compact_grid<3>>(); }
@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "loose_grid.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace ungrd;
+
+// Updates a loose grid with points in a box of 32^3 cells that jitter by up to
+// a tenth of the cell size per frame. The margin is given in percent of the
+// cell size, the moves counter is the fraction of entries that changed cells.
+template <typename Grid>
+void BMT_LooseGrid_Jitter(benchmark::State &state) {
+  using loose_grid_type = loose_grid<Grid>;
+  using point_type = typename loose_grid_type::point_type;
+
+  std::mt19937 gen{0};
+  std::uniform_real_distribution<float> coordinate_dis{0.f, 32.f};
+  std::uniform_real_distribution<float> step_dis{-0.1f, 0.1f};
+
+  std::vector<point_type> points(32 * 32 * 32 * 4);
+  for (auto &point : points)
+    for (auto &coordinate : point)
+      coordinate = coordinate_dis(gen);
+
+  // a few frames of jitter, replayed over and over
+  std::vector<std::vector<point_type>> frames(8, points);
+  for (size_t frame = 1; frame < frames.size(); ++frame)
+    for (size_t entry = 0; entry < points.size(); ++entry)
+      for (size_t dim = 0; dim < 3; ++dim)
+        frames[frame][entry][dim] =
+            frames[frame - 1][entry][dim] + step_dis(gen);
+
+  loose_grid_type grid{state.range(0) / 100.f};
+  grid.update(frames[0]);
+
+  size_t frame = 0, move_count = 0;
+  for (auto _ : state) {
+    frame = (frame + 1) % frames.size();
+    grid.update(frames[frame]);
+    move_count += grid.move_count();
+  }
+
+  state.SetItemsProcessed(state.iterations() * points.size());
+  state.counters["moves"] =
+      double(move_count) / (state.iterations() * points.size());
+}
+BENCHMARK_TEMPLATE(BMT_LooseGrid_Jitter, s32_e32_dense_grid<3>)
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(25)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BMT_LooseGrid_Jitter, s32_e32_compact_grid<3>)
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(25)
+    ->Unit(benchmark::kMillisecond);
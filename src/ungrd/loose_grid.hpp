@@ -0,0 +1,198 @@
+#ifndef UNGRD_LOOSE_GRID_HPP_07B977D246CF4328A8DCED8C10F77BC6
+#define UNGRD_LOOSE_GRID_HPP_07B977D246CF4328A8DCED8C10F77BC6
+
+#include "cxx/assert.hpp"
+#include "cxx/narrow.hpp"
+
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace ungrd {
+
+// Wraps a grid whose entries are indices into an array of points, given in
+// units of the cell size. An entry keeps its cell until its point leaves the
+// cell expanded by margin on every side, so points that jitter around a cell
+// boundary do not move between cells on every update.
+//
+// An entry whose point is in the cell cpos is stored in a cell at most
+// margin_cells() away from cpos in every dimension. Box queries widen the box
+// by that many cells and return a superset of the entries whose points are in
+// the box, callers test the actual points anyway.
+template <typename TGrid, typename TReal = float>
+class loose_grid {
+public:
+  using grid_type = TGrid;
+  using space_policy = typename grid_type::space_policy;
+  using entry_policy = typename grid_type::entry_policy;
+
+private:
+  static constexpr std::size_t ndim = space_policy::ndim;
+  using position_type = typename space_policy::position;
+  using position_index_type = typename position_type::value_type;
+
+  using entry_type = typename entry_policy::entry;
+
+  static_assert(
+      std::is_void_v<typename entry_policy::payload>,
+      "payloads would have to be updated for entries that keep their cell");
+  static_assert(
+      not space_policy::periodic,
+      "widened boxes are clipped to the domain instead of wrapping");
+
+public:
+  using point_type = std::array<TReal, ndim>;
+
+public:
+  grid_type const &grid() const { return grid_; }
+
+  TReal margin() const { return margin_; }
+
+  // the number of cells by which queries widen their boxes
+  position_index_type margin_cells() const {
+    return static_cast<position_index_type>(std::ceil(margin_));
+  }
+
+  // the number of entries that moved to another cell in the last update
+  size_t move_count() const { return move_count_; }
+
+  // the cell that entry is stored in
+  position_type const &entry_position(entry_type const entry) const {
+    return entry_cposes_[entry];
+  }
+
+  std::pair<position_type, position_type> bounding_box() const {
+    return grid_.bounding_box();
+  }
+
+public:
+  // Calls callback(entry) for every entry whose point may be in the cells of
+  // the box [lo, hi] and possibly for some entries close to the box.
+  template <typename FCallback>
+  void foreach_entry_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    position_type wide_lo = lo, wide_hi = hi;
+    widen_box(wide_lo, wide_hi);
+    grid_.foreach_entry_in_box(wide_lo, wide_hi, callback);
+  }
+
+  // Calls callback(view) for every filled cell that may hold entries whose
+  // points are in the cells of the box [lo, hi].
+  template <typename FCallback>
+  void foreach_cell_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    position_type wide_lo = lo, wide_hi = hi;
+    widen_box(wide_lo, wide_hi);
+    grid_.foreach_cell_in_box(wide_lo, wide_hi, callback);
+  }
+
+public:
+  // Updates the grid with the points of the entries 0, 1, ..., size(points)-1.
+  // Only entries that left their expanded cell are moved, unless the number of
+  // entries changed, which rebuilds the grid.
+  template <typename TPoints>
+  void update(TPoints const &points) {
+    using std::size;
+    size_t const entry_count = size(points);
+
+    if (entry_count != entry_cposes_.size()) {
+      rebuild(points);
+      return;
+    }
+
+    fresh_.clear();
+    stale_.clear();
+
+    for (size_t entry = 0; entry < entry_count; ++entry) {
+      auto &cpos = entry_cposes_[entry];
+      auto const &point = points[entry];
+
+      bool inside = true;
+      for (size_t dim = 0; dim < ndim; ++dim) {
+        auto const lo = static_cast<TReal>(cpos[dim]) - margin_;
+        auto const hi = static_cast<TReal>(cpos[dim]) + 1 + margin_;
+        inside = inside and lo <= point[dim] and point[dim] < hi;
+      }
+
+      if (not inside) {
+        stale_.emplace_back(cpos, narrow<entry_type>(entry));
+        cpos = point_to_cpos(point);
+        fresh_.emplace_back(cpos, narrow<entry_type>(entry));
+      }
+    }
+
+    move_count_ = fresh_.size();
+    grid_.differential_update(fresh_, stale_);
+  }
+
+  // Rebuilds the grid, every entry is put into the cell of its point.
+  template <typename TPoints>
+  void rebuild(TPoints const &points) {
+    using std::size;
+    size_t const entry_count = size(points);
+
+    entry_cposes_.resize(entry_count);
+    fresh_.clear();
+    for (size_t entry = 0; entry < entry_count; ++entry) {
+      auto const cpos = point_to_cpos(points[entry]);
+      entry_cposes_[entry] = cpos;
+      fresh_.emplace_back(cpos, narrow<entry_type>(entry));
+    }
+
+    move_count_ = entry_count;
+    grid_.update(fresh_);
+  }
+
+private:
+  static position_type point_to_cpos(point_type const &point) {
+    position_type cpos;
+    for (size_t dim = 0; dim < ndim; ++dim)
+      cpos[dim] = static_cast<position_index_type>(std::floor(point[dim]));
+    return cpos;
+  }
+
+  void widen_box(position_type &lo, position_type &hi) const {
+    auto const cells = margin_cells();
+    auto const most_negative = space_policy::most_negative_position();
+    auto const most_positive = space_policy::most_positive_position();
+
+    // saturate instead of overflowing at the ends of the position range
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      lo[dim] = lo[dim] < most_negative[dim] + cells ? most_negative[dim]
+                                                     : lo[dim] - cells;
+      hi[dim] = hi[dim] > most_positive[dim] - cells ? most_positive[dim]
+                                                     : hi[dim] + cells;
+    }
+  }
+
+public:
+  explicit loose_grid(TReal const margin, grid_type grid = grid_type{})
+      : grid_{std::move(grid)}, margin_{margin} {
+    UNGRD_ASSERT(margin must not be negative, margin >= 0);
+  }
+
+  loose_grid(loose_grid const &) = delete;
+  loose_grid &operator=(loose_grid const &) = delete;
+  loose_grid(loose_grid &&) = default;
+  loose_grid &operator=(loose_grid &&) = default;
+
+private:
+  grid_type grid_;
+  TReal margin_;
+
+  std::vector<position_type> entry_cposes_ = {};
+  size_t move_count_ = 0;
+
+  std::vector<std::pair<position_type, entry_type>> fresh_ = {};
+  std::vector<std::pair<position_type, entry_type>> stale_ = {};
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_LOOSE_GRID_HPP_07B977D246CF4328A8DCED8C10F77BC6
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "loose_grid.hpp"
+
+#include "cxx/set.hpp"
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace ungrd;
+
+namespace {
+
+// Jitters points and checks that every entry is stored once, within the margin
+// of its point, and that box queries find every entry whose point is inside.
+template <typename Grid>
+void T_LooseGrid_Jitter(float const margin) {
+  using loose_grid_type = loose_grid<Grid>;
+  using point_type = typename loose_grid_type::point_type;
+  using position_type = typename Grid::space_policy::position;
+
+  std::mt19937 gen{0};
+  std::uniform_real_distribution<float> coordinate_dis{-5.f, 5.f};
+  std::uniform_real_distribution<float> step_dis{-0.2f, 0.2f};
+  std::uniform_int_distribution<int> box_dis{-6, 6};
+
+  loose_grid_type grid{margin};
+
+  std::vector<point_type> points(300);
+  for (auto &point : points)
+    for (auto &coordinate : point)
+      coordinate = coordinate_dis(gen);
+
+  grid.update(points);
+  ASSERT_EQ(points.size(), grid.move_count());
+
+  auto const point_to_cpos = [](point_type const &point) {
+    position_type cpos;
+    for (size_t dim = 0; dim < 3; ++dim)
+      cpos[dim] = static_cast<int>(std::floor(point[dim]));
+    return cpos;
+  };
+
+  auto const check = [&] {
+    std::vector<size_t> counts(points.size());
+    grid.grid().foreach_position([&](auto const &cpos) {
+      grid.grid().foreach_entry_at_position(cpos, [&](auto const entry) {
+        ++counts[entry];
+        ASSERT_EQ(cpos, grid.entry_position(entry));
+        for (size_t dim = 0; dim < 3; ++dim) {
+          ASSERT_LE(cpos[dim] - margin, points[entry][dim]);
+          ASSERT_LT(points[entry][dim], cpos[dim] + 1 + margin);
+        }
+      });
+    });
+    for (auto const count : counts)
+      ASSERT_EQ(1u, count);
+
+    for (size_t round = 0; round < 20; ++round) {
+      position_type lo, hi;
+      for (size_t dim = 0; dim < 3; ++dim) {
+        lo[dim] = box_dis(gen);
+        hi[dim] = lo[dim] + 2;
+      }
+
+      hash_set<std::uint32_t> entries;
+      grid.foreach_entry_in_box(
+          lo, hi, [&entries](auto const entry) { entries.insert(entry); });
+
+      for (std::uint32_t entry = 0; entry < points.size(); ++entry) {
+        auto const cpos = point_to_cpos(points[entry]);
+        bool inside = true;
+        for (size_t dim = 0; dim < 3; ++dim)
+          inside = inside and lo[dim] <= cpos[dim] and cpos[dim] <= hi[dim];
+        if (inside) {
+          ASSERT_TRUE(entries.contains(entry));
+        }
+      }
+    }
+  };
+
+  check();
+
+  for (size_t frame = 0; frame < 30; ++frame) {
+    size_t cell_changes = 0;
+    for (auto &point : points) {
+      auto const old_cpos = point_to_cpos(point);
+      for (auto &coordinate : point)
+        coordinate += step_dis(gen);
+      cell_changes += point_to_cpos(point) != old_cpos;
+    }
+
+    grid.update(points);
+    if (margin == 0) {
+      ASSERT_EQ(cell_changes, grid.move_count());
+    } else {
+      ASSERT_LE(grid.move_count(), points.size());
+    }
+    check();
+  }
+
+  // a different number of entries rebuilds the grid
+  points.resize(100);
+  grid.update(points);
+  ASSERT_EQ(points.size(), grid.move_count());
+  check();
+}
+
+} // namespace
+
+TEST(LooseGrid, DenseGridNoMargin) {
+  T_LooseGrid_Jitter<s32_e32_dense_grid<3>>(0.f);
+}
+
+TEST(LooseGrid, DenseGrid) { T_LooseGrid_Jitter<s32_e32_dense_grid<3>>(0.3f); }
+
+TEST(LooseGrid, CompactGrid) {
+  T_LooseGrid_Jitter<s32_e32_compact_grid<3>>(1.5f);
+}
+
+TEST(LooseGrid, MarginCells) {
+  ASSERT_EQ(0, loose_grid<s32_e32_dense_grid<3>>{0.f}.margin_cells());
+  ASSERT_EQ(1, loose_grid<s32_e32_dense_grid<3>>{0.25f}.margin_cells());
+  ASSERT_EQ(1, loose_grid<s32_e32_dense_grid<3>>{1.f}.margin_cells());
+  ASSERT_EQ(2, loose_grid<s32_e32_dense_grid<3>>{1.5f}.margin_cells());
+}
@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "neighbour_list.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace ungrd;
+
+// Updates the neighbour lists of points in a box of 32^3 cells, four per cell,
+// that jitter by up to a hundredth of the cell size per frame, and visits the
+// neighbours within one cell size of every point. The skin is given in percent
+// of the cell size, a skin of 0 rebuilds every frame. The rebuilds counter is
+// the fraction of frames that rebuilt the lists.
+template <typename Grid>
+void BMT_NeighbourList_Jitter(benchmark::State &state) {
+  using list_type = neighbour_list<Grid>;
+  using point_type = typename list_type::point_type;
+
+  std::mt19937 gen{0};
+  std::uniform_real_distribution<float> coordinate_dis{0.f, 32.f};
+  std::uniform_real_distribution<float> step_dis{-0.01f, 0.01f};
+
+  std::vector<point_type> points(32 * 32 * 32 * 4);
+  for (auto &point : points)
+    for (auto &coordinate : point)
+      coordinate = coordinate_dis(gen);
+
+  // a random walk of a few frames, replayed forth and back
+  std::vector<std::vector<point_type>> frames(16, points);
+  for (size_t frame = 1; frame < frames.size(); ++frame)
+    for (size_t entry = 0; entry < points.size(); ++entry)
+      for (size_t dim = 0; dim < 3; ++dim)
+        frames[frame][entry][dim] =
+            frames[frame - 1][entry][dim] + step_dis(gen);
+
+  list_type list{1.f, state.range(0) / 100.f};
+  list.update(frames[0]);
+
+  size_t const rebuild_count = list.rebuild_count();
+  size_t step = 0;
+  for (auto _ : state) {
+    auto const phase = ++step % (2 * frames.size() - 2);
+    auto const frame =
+        phase < frames.size() ? phase : 2 * frames.size() - 2 - phase;
+    list.update(frames[frame]);
+
+    size_t count = 0;
+    for (size_t entry = 0; entry < points.size(); ++entry)
+      list.foreach_neighbour(entry, [&count](auto const) { ++count; });
+    benchmark::DoNotOptimize(count);
+  }
+
+  state.SetItemsProcessed(state.iterations() * points.size());
+  state.counters["rebuilds"] =
+      double(list.rebuild_count() - rebuild_count) / state.iterations();
+}
+BENCHMARK_TEMPLATE(BMT_NeighbourList_Jitter, s32_e32_dense_grid<3>)
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(30)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BMT_NeighbourList_Jitter, s32_e32_compact_grid<3>)
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(30)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,251 @@
+#ifndef UNGRD_NEIGHBOUR_LIST_HPP_D4FAA43215F64B88AAD9A3B7117538E3
+#define UNGRD_NEIGHBOUR_LIST_HPP_D4FAA43215F64B88AAD9A3B7117538E3
+
+#include "cxx/assert.hpp"
+#include "cxx/narrow.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace ungrd {
+
+// Caches, for every entry, the entries whose points are within radius + skin
+// of its point, like the Verlet lists of molecular dynamics codes. Entries are
+// indices into an array of points, given in units of the cell size.
+//
+// The grid and the lists are only rebuilt once some point has moved more than
+// skin / 2 since the last rebuild. Until then no two points that were further
+// apart than radius + skin can have come within radius of each other, so the
+// cached lists, filtered by the actual distance, are exact.
+template <typename TGrid, typename TReal = float>
+class neighbour_list {
+public:
+  using grid_type = TGrid;
+  using space_policy = typename grid_type::space_policy;
+  using entry_policy = typename grid_type::entry_policy;
+
+private:
+  static constexpr std::size_t ndim = space_policy::ndim;
+  using position_type = typename space_policy::position;
+  using position_index_type = typename position_type::value_type;
+
+  using entry_type = typename entry_policy::entry;
+
+  static_assert(
+      std::is_void_v<typename entry_policy::payload>,
+      "the lists only hold entries");
+  static_assert(
+      not space_policy::periodic,
+      "distances are not wrapped around periodic spaces");
+
+  // the lists of this many consecutive entries are built by one thread
+  static constexpr std::size_t chunk_size = 256;
+
+public:
+  using point_type = std::array<TReal, ndim>;
+
+public:
+  grid_type const &grid() const { return grid_; }
+
+  TReal radius() const { return radius_; }
+  TReal skin() const { return skin_; }
+
+  // the number of times the lists were built
+  size_t rebuild_count() const { return rebuild_count_; }
+
+  // whether the last update rebuilt the lists
+  bool rebuilt() const { return rebuilt_; }
+
+  // The entries that were within radius + skin of entry at the last rebuild,
+  // a superset of its neighbours.
+  std::span<entry_type const> candidates(entry_type const entry) const {
+    return {
+        neighbours_.data() + offsets_[entry],
+        neighbours_.data() + offsets_[entry + 1]};
+  }
+
+  // Calls callback(neighbour) for every other entry whose point is within
+  // radius of the point of entry, with the points of the last update.
+  template <typename FCallback>
+  void foreach_neighbour(entry_type const entry, FCallback callback) const {
+    auto const &point = points_[entry];
+    auto const radius2 = radius_ * radius_;
+    for (auto const neighbour : candidates(entry))
+      if (distance2(point, points_[neighbour]) <= radius2)
+        callback(neighbour);
+  }
+
+public:
+  // Updates the points of the entries 0, 1, ..., size(points)-1. Rebuilds the
+  // grid and the lists if a point moved more than skin / 2 since the last
+  // rebuild or if the number of entries changed.
+  template <typename TPoints>
+  void update(TPoints const &points) {
+    using std::size;
+    size_t const entry_count = size(points);
+
+    if (entry_count != reference_points_.size()) {
+      rebuild(points);
+      return;
+    }
+
+    for (size_t entry = 0; entry < entry_count; ++entry)
+      points_[entry] = points[entry];
+
+    TReal max_displacement2 = 0;
+    auto const *const current = points_.data();
+    auto const *const reference = reference_points_.data();
+
+#pragma omp parallel for simd schedule(static)                                 \
+    reduction(max : max_displacement2)
+    for (size_t entry = 0; entry < entry_count; ++entry)
+      max_displacement2 = std::max(
+          max_displacement2, distance2(current[entry], reference[entry]));
+
+    // compares 2 * displacement with the skin
+    if (4 * max_displacement2 > skin_ * skin_) {
+      rebuild(points);
+      return;
+    }
+    rebuilt_ = false;
+  }
+
+  // Rebuilds the grid and the lists with the points of all entries.
+  template <typename TPoints>
+  void rebuild(TPoints const &points) {
+    using std::size;
+    size_t const entry_count = size(points);
+
+    points_.resize(entry_count);
+    fresh_.clear();
+    for (size_t entry = 0; entry < entry_count; ++entry) {
+      points_[entry] = points[entry];
+      fresh_.emplace_back(
+          point_to_cpos(points_[entry]), narrow<entry_type>(entry));
+    }
+    reference_points_ = points_;
+    grid_.update(fresh_);
+
+    build_lists();
+    ++rebuild_count_;
+    rebuilt_ = true;
+  }
+
+private:
+  // Builds the lists in parallel. Every chunk of entries collects its lists in
+  // a buffer, which is then copied to its place in neighbours_.
+  void build_lists() {
+    size_t const entry_count = points_.size();
+    size_t const chunk_count = (entry_count + chunk_size - 1) / chunk_size;
+
+    chunks_.resize(chunk_count);
+    offsets_.assign(entry_count + 1, 0);
+
+    auto const cutoff = radius_ + skin_;
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+      auto &buffer = chunks_[chunk];
+      buffer.clear();
+
+      size_t const last = std::min(entry_count, (chunk + 1) * chunk_size);
+      for (size_t entry = chunk * chunk_size; entry < last; ++entry) {
+        size_t const first = buffer.size();
+        foreach_entry_within(
+            points_[entry], cutoff, [&buffer, entry](entry_type const other) {
+              if (other != entry)
+                buffer.push_back(other);
+            });
+        offsets_[entry + 1] = buffer.size() - first;
+      }
+    }
+
+    for (size_t entry = 0; entry < entry_count; ++entry)
+      offsets_[entry + 1] += offsets_[entry];
+    neighbours_.resize(offsets_[entry_count]);
+
+#pragma omp parallel for schedule(static)
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk)
+      std::copy(
+          chunks_[chunk].begin(), chunks_[chunk].end(),
+          neighbours_.begin() + offsets_[chunk * chunk_size]);
+  }
+
+  // Calls callback(entry) for every entry whose point is within cutoff of
+  // point.
+  template <typename FCallback>
+  void foreach_entry_within(
+      point_type const &point, TReal const cutoff, FCallback callback) const {
+    point_type lo_point, hi_point;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      lo_point[dim] = point[dim] - cutoff;
+      hi_point[dim] = point[dim] + cutoff;
+    }
+
+    auto const cutoff2 = cutoff * cutoff;
+    grid_.foreach_entry_in_box(
+        point_to_cpos(lo_point), point_to_cpos(hi_point),
+        [this, &point, cutoff2, &callback](entry_type const entry) {
+          if (distance2(point, points_[entry]) <= cutoff2)
+            callback(entry);
+        });
+  }
+
+  static TReal distance2(point_type const &a, point_type const &b) {
+    TReal result = 0;
+    for (size_t dim = 0; dim < ndim; ++dim)
+      result += (a[dim] - b[dim]) * (a[dim] - b[dim]);
+    return result;
+  }
+
+  static position_type point_to_cpos(point_type const &point) {
+    position_type cpos;
+    for (size_t dim = 0; dim < ndim; ++dim)
+      cpos[dim] = static_cast<position_index_type>(std::floor(point[dim]));
+    return cpos;
+  }
+
+public:
+  neighbour_list(
+      TReal const radius, TReal const skin, grid_type grid = grid_type{})
+      : grid_{std::move(grid)}, radius_{radius}, skin_{skin} {
+    UNGRD_ASSERT(radius must not be negative, radius >= 0);
+    UNGRD_ASSERT(skin must not be negative, skin >= 0);
+  }
+
+  neighbour_list(neighbour_list const &) = delete;
+  neighbour_list &operator=(neighbour_list const &) = delete;
+  neighbour_list(neighbour_list &&) = default;
+  neighbour_list &operator=(neighbour_list &&) = default;
+
+private:
+  grid_type grid_;
+  TReal radius_;
+  TReal skin_;
+
+  size_t rebuild_count_ = 0;
+  bool rebuilt_ = false;
+
+  // the points of the last update and of the last rebuild
+  std::vector<point_type> points_ = {};
+  std::vector<point_type> reference_points_ = {};
+
+  // the candidates of entry are neighbours_[offsets_[entry],
+  // offsets_[entry + 1])
+  std::vector<size_t> offsets_ = {0};
+  std::vector<entry_type> neighbours_ = {};
+
+  std::vector<std::vector<entry_type>> chunks_ = {};
+  std::vector<std::pair<position_type, entry_type>> fresh_ = {};
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_NEIGHBOUR_LIST_HPP_D4FAA43215F64B88AAD9A3B7117538E3
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "neighbour_list.hpp"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+using namespace ungrd;
+
+namespace {
+
+// Jitters points and compares the neighbours of every entry with a brute force
+// search.
+template <typename Grid>
+void T_NeighbourList_Jitter() {
+  using list_type = neighbour_list<Grid>;
+  using point_type = typename list_type::point_type;
+  using entry_type = typename Grid::entry_policy::entry;
+
+  std::mt19937 gen{0};
+  std::uniform_real_distribution<float> coordinate_dis{-4.f, 4.f};
+  std::uniform_real_distribution<float> step_dis{-0.05f, 0.05f};
+
+  float const radius = 1.f, skin = .3f;
+  list_type list{radius, skin};
+
+  std::vector<point_type> points(400);
+  for (auto &point : points)
+    for (auto &coordinate : point)
+      coordinate = coordinate_dis(gen);
+
+  auto const check = [&] {
+    for (size_t entry = 0; entry < points.size(); ++entry) {
+      std::vector<entry_type> expected;
+      for (size_t other = 0; other < points.size(); ++other) {
+        float distance2 = 0;
+        for (size_t dim = 0; dim < 3; ++dim) {
+          auto const d = points[entry][dim] - points[other][dim];
+          distance2 += d * d;
+        }
+        if (other != entry and distance2 <= radius * radius)
+          expected.push_back(static_cast<entry_type>(other));
+      }
+
+      std::vector<entry_type> neighbours;
+      list.foreach_neighbour(
+          static_cast<entry_type>(entry),
+          [&neighbours](entry_type const neighbour) {
+            neighbours.push_back(neighbour);
+          });
+      std::sort(neighbours.begin(), neighbours.end());
+      ASSERT_EQ(expected, neighbours);
+    }
+  };
+
+  list.update(points);
+  ASSERT_TRUE(list.rebuilt());
+  ASSERT_EQ(1u, list.rebuild_count());
+  check();
+
+  // a step moves a point by at most 0.05 * sqrt(3) < skin / 2, so the first
+  // step keeps the lists
+  for (size_t step = 0; step < 20; ++step) {
+    for (auto &point : points)
+      for (auto &coordinate : point)
+        coordinate += step_dis(gen);
+
+    list.update(points);
+    if (step == 0) {
+      ASSERT_FALSE(list.rebuilt());
+    }
+    check();
+  }
+  ASSERT_LT(list.rebuild_count(), 21u);
+  ASSERT_LT(1u, list.rebuild_count());
+
+  // a different number of entries rebuilds
+  points.resize(100);
+  list.update(points);
+  ASSERT_TRUE(list.rebuilt());
+  check();
+}
+
+} // namespace
+
+TEST(NeighbourList, DenseGridJitter) {
+  T_NeighbourList_Jitter<s32_e32_dense_grid<3>>();
+}
+
+TEST(NeighbourList, CompactGridJitter) {
+  T_NeighbourList_Jitter<s32_e32_compact_grid<3>>();
+}
@@ -1,8 +1,10 @@
 #include <benchmark/benchmark.h>
 
+#include "concurrent_object_pool.hpp"
 #include "object_pool.hpp"
 
 #include <array>
+#include <mutex>
 #include <numeric>
 
 #define GENERATE_BENCHMARKS(BM_)                                               \
@@ -15,6 +17,11 @@
   BENCHMARK_TEMPLATE(BM_, 4096)->Range(1, 4096);                               \
   BENCHMARK_TEMPLATE(BM_, 8192)->Range(1, 8192);
 
+#define GENERATE_THREADED_BENCHMARKS(BM_)                                      \
+  BENCHMARK_TEMPLATE(BM_, 8)->Range(1, 1024)->ThreadRange(1, 8);               \
+  BENCHMARK_TEMPLATE(BM_, 1024)->Range(1, 16)->ThreadRange(1, 8);              \
+  BENCHMARK_TEMPLATE(BM_, 4096)->Range(1, 4096)->ThreadRange(1, 8);
+
 template <typename T, size_t N>
 struct iota_array {
   iota_array() { std::iota(data.begin(), data.end(), 0); }
@@ -121,3 +128,150 @@ static void BM_ObjectPool_AcquireManyReleaseMany(benchmark::State &state) {
   }
 }
 GENERATE_BENCHMARKS(BM_ObjectPool_AcquireManyReleaseMany)
+
+// AcquireBulkReleaseBulk
+
+template <size_t NBytes>
+static void BM_ObjectPool_AcquireBulkReleaseBulk(benchmark::State &state) {
+  using object_type = iota_array<char, NBytes>;
+
+  {
+    auto &pool = ungrd::get_object_pool<object_type>();
+    pool.clear();
+    state.counters["cb"] = pool.count_chunks();
+    state.counters["acb"] = pool.count_available_chunks();
+    state.counters["aob"] = pool.count_available_objects();
+  }
+
+  auto &pool = ungrd::get_object_pool<object_type>();
+
+  std::vector<object_type *> objects(state.range(0));
+
+  for (auto _ : state) {
+    pool.acquire_n(objects.size(), objects.begin());
+    for (size_t index = 0; index < objects.size(); ++index)
+      new (objects[index]) object_type;
+
+    benchmark::DoNotOptimize(objects);
+
+    for (size_t index = 0; index < objects.size(); ++index)
+      objects[index]->~object_type();
+    pool.release_n(objects);
+  }
+
+  {
+    state.counters["ca"] = pool.count_chunks();
+    state.counters["aca"] = pool.count_available_chunks();
+    state.counters["aoa"] = pool.count_available_objects();
+  }
+}
+GENERATE_BENCHMARKS(BM_ObjectPool_AcquireBulkReleaseBulk)
+
+template <size_t NBytes>
+static void
+BM_ObjectPool_HugePage_AcquireBulkReleaseBulk(benchmark::State &state) {
+  using object_type = iota_array<char, NBytes>;
+
+  static ungrd::huge_page_object_pool<object_type> pool;
+  pool.clear();
+
+  std::vector<object_type *> objects(state.range(0));
+
+  for (auto _ : state) {
+    pool.acquire_n(objects.size(), objects.begin());
+    for (size_t index = 0; index < objects.size(); ++index)
+      new (objects[index]) object_type;
+
+    benchmark::DoNotOptimize(objects);
+
+    for (size_t index = 0; index < objects.size(); ++index)
+      objects[index]->~object_type();
+    pool.release_n(objects);
+  }
+
+  state.counters["ca"] = pool.count_chunks();
+  state.counters["aoa"] = pool.count_available_objects();
+}
+GENERATE_BENCHMARKS(BM_ObjectPool_HugePage_AcquireBulkReleaseBulk)
+
+// Threaded_AcquireManyReleaseMany
+
+template <size_t NBytes>
+static void BM_ObjectPool_Threaded_NewManyDeleteMany(benchmark::State &state) {
+  using object_type = iota_array<char, NBytes>;
+
+  std::vector<object_type *> objects(state.range(0));
+
+  for (auto _ : state) {
+    for (size_t index = 0; index < objects.size(); ++index)
+      objects[index] = new object_type;
+
+    benchmark::DoNotOptimize(objects);
+
+    for (size_t index = 0; index < objects.size(); ++index)
+      delete objects[index];
+  }
+}
+GENERATE_THREADED_BENCHMARKS(BM_ObjectPool_Threaded_NewManyDeleteMany)
+
+template <size_t NBytes>
+static void
+BM_ObjectPool_Threaded_LockedAcquireManyReleaseMany(benchmark::State &state) {
+  using object_type = iota_array<char, NBytes>;
+
+  // the single-threaded pool can only be shared behind a lock
+  static std::mutex pool_mutex;
+  auto &pool = ungrd::get_object_pool<object_type>();
+
+  std::vector<object_type *> objects(state.range(0));
+
+  for (auto _ : state) {
+    for (size_t index = 0; index < objects.size(); ++index) {
+      {
+        std::lock_guard lock{pool_mutex};
+        objects[index] = pool.acquire();
+      }
+      new (objects[index]) object_type;
+    }
+
+    benchmark::DoNotOptimize(objects);
+
+    for (size_t index = 0; index < objects.size(); ++index) {
+      objects[index]->~object_type();
+      std::lock_guard lock{pool_mutex};
+      pool.release(objects[index]);
+    }
+  }
+}
+GENERATE_THREADED_BENCHMARKS(
+    BM_ObjectPool_Threaded_LockedAcquireManyReleaseMany)
+
+template <size_t NBytes>
+static void
+BM_ObjectPool_Threaded_ConcurrentAcquireManyReleaseMany(
+    benchmark::State &state) {
+  using object_type = iota_array<char, NBytes>;
+
+  std::vector<object_type *> objects(state.range(0));
+
+  for (auto _ : state) {
+    for (size_t index = 0; index < objects.size(); ++index) {
+      objects[index] = ungrd::acquire_concurrent_object<object_type>();
+      new (objects[index]) object_type;
+    }
+
+    benchmark::DoNotOptimize(objects);
+
+    for (size_t index = 0; index < objects.size(); ++index) {
+      objects[index]->~object_type();
+      ungrd::release_concurrent_object<object_type>(objects[index]);
+    }
+  }
+
+  if (state.thread_index() == 0) {
+    auto &pool = ungrd::get_concurrent_object_pool<object_type>();
+    state.counters["ca"] = pool.count_chunks();
+  }
+}
+GENERATE_THREADED_BENCHMARKS(
+    BM_ObjectPool_Threaded_ConcurrentAcquireManyReleaseMany)
@@ -1,20 +1,43 @@
 #ifndef UNGRD_OBJECT_POOL_HPP_342D7BEE3B97459E81B29FD160C4E869
 #define UNGRD_OBJECT_POOL_HPP_342D7BEE3B97459E81B29FD160C4E869
 
+#include "chunk_memory.hpp"
+#include "cxx/hierarchical_static_bitset.hpp"
 #include "cxx/static_bitset.hpp"
 
 #include <algorithm>
 #include <array>
 #include <bit>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
+#include <cassert>
+
 namespace ungrd {
 
+// Object types for which new chunks are default initialized instead of value
+// initialized. Fresh slots of trivial types then hold indeterminate values, but
+// the pages of a chunk are only touched once objects on them are used.
 template <typename TObject>
+inline constexpr bool default_initialize_pool_objects = false;
+
+// Hands out TObject slots from chunks of (about) NChunkBytes bytes, whose
+// memory is provided by TChunkMemory. The objects of a new chunk are value
+// initialized, unless default_initialize_pool_objects opts out.
+template <
+    typename TObject, size_t NChunkBytes = 4096,
+    typename TChunkMemory = heap_chunk_memory>
 class object_pool {
 public:
   using object_type = TObject;
+  using chunk_memory = TChunkMemory;
+
+  static constexpr size_t chunk_bytes = NChunkBytes;
 
 public:
   constexpr size_t count_chunks() const { return chunks_.size(); }
@@ -30,12 +53,19 @@ public:
     return count;
   }
 
+  // fragmentation report, lists the number of available objects per chunk
+  std::vector<size_t> count_available_objects_per_chunk() const {
+    std::vector<size_t> counts;
+    counts.reserve(chunks_.size());
+    for (auto const &chunk : chunks_)
+      counts.emplace_back(chunk->size() - chunk->count_used_objects());
+    return counts;
+  }
+
 public:
   TObject *acquire() {
-    if (available_chunks_.empty()) {
-      auto *chunk = chunks_.emplace_back(std::make_unique<chunk_type>()).get();
-      available_chunks_.emplace_back(chunk);
-    }
+    if (available_chunks_.empty())
+      add_chunk();
 
     auto &chunk = *available_chunks_.back();
     auto const [object, has_none_available] = chunk.acquire();
@@ -46,14 +76,76 @@ public:
   }
 
   void release(TObject *object) {
-    for (auto &chunk : chunks_) {
-      if (chunk->contains(object)) {
-        if (chunk->release(object))
-          available_chunks_.emplace_back(chunk.get());
-        return;
+    auto *chunk = find_chunk(object);
+    if (chunk->release(object))
+      available_chunks_.emplace_back(chunk);
+  }
+
+public:
+  // Acquires count objects and writes pointers to them into output. Free
+  // objects are claimed a whole chunk word at a time, so runs of contiguous
+  // objects are handed out in order.
+  template <typename OutputIt>
+  OutputIt acquire_n(size_t count, OutputIt output) {
+    while (count > 0) {
+      if (available_chunks_.empty())
+        add_chunk();
+
+      auto &chunk = *available_chunks_.back();
+      auto const [acquired, next, has_none_available] =
+          chunk.acquire_n(count, output);
+      if (has_none_available)
+        available_chunks_.pop_back();
+
+      output = next;
+      count -= acquired;
+    }
+    return output;
+  }
+
+  // Releases all objects in the range. Consecutive objects from the same chunk
+  // word are released with a single word operation.
+  template <typename TRange>
+  void release_n(TRange const &objects) {
+    using word_type = typename used_bitset::chunk_type;
+    constexpr size_t word_bits = used_bitset::bits_per_chunk();
+
+    chunk_type *chunk = nullptr;
+    bool chunk_was_full = false;
+    size_t word_index = 0;
+    word_type word_mask = 0;
+
+    auto const flush_word = [&] {
+      if (word_mask != 0)
+        chunk->used.set_chunk(
+            word_index, chunk->used.get_chunk(word_index) & ~word_mask);
+      word_mask = 0;
+    };
+
+    auto const flush_chunk = [&] {
+      flush_word();
+      if (chunk_was_full)
+        available_chunks_.emplace_back(chunk);
+    };
+
+    for (TObject *object : objects) {
+      if (chunk == nullptr or not chunk->contains(object)) {
+        if (chunk != nullptr)
+          flush_chunk();
+        chunk = find_chunk(object);
+        chunk_was_full = chunk->used.all();
+      }
+
+      size_t const index = std::distance(chunk->objects.data(), object);
+      if (index / word_bits != word_index) {
+        flush_word();
+        word_index = index / word_bits;
       }
+      word_mask |= word_type{1} << (index % word_bits);
     }
-    assert(not "object was not contained in any chunk");
+
+    if (chunk != nullptr)
+      flush_chunk();
   }
 
 public:
@@ -82,16 +174,51 @@ public:
     chunks_.clear();
   }
 
+  // Frees all chunks without used objects and returns how many were freed.
+  size_t trim() {
+    auto const is_unused = [](chunk_type const *chunk) {
+      return chunk->used.none();
+    };
+
+    std::erase_if(available_chunks_, is_unused);
+    return std::erase_if(
+        chunks_, [&is_unused](auto const &chunk) {
+          return is_unused(chunk.get());
+        });
+  }
+
+private:
+  // larger chunks keep summary bits to find free objects in constant time
+  template <size_t NObjects>
+  using used_bitset_for = std::conditional_t<
+      (NObjects > 256), hierarchical_static_bitset<NObjects>,
+      static_bitset<NObjects>>;
+
+  // the number of objects such that a chunk including its bitset fits into
+  // NChunkBytes, the bitset without subtracting its own size is an upper bound
+  static constexpr size_t chunk_size = [] {
+    size_t const object_size = sizeof(TObject);
+    size_t const object_align = alignof(TObject);
+    size_t const max_bitset_bytes = sizeof(
+        used_bitset_for<std::max<size_t>(NChunkBytes / sizeof(TObject), 1)>);
+    size_t const objects_offset =
+        (max_bitset_bytes + object_align - 1) / object_align * object_align;
+    if (objects_offset >= NChunkBytes)
+      return size_t{1};
+    return std::max<size_t>((NChunkBytes - objects_offset) / object_size, 1);
+  }();
+
+  using used_bitset = used_bitset_for<chunk_size>;
+
+public:
+  static constexpr size_t objects_per_chunk = chunk_size;
+
 private:
   struct chunk_type {
-    static constexpr size_t chunk_size = [] {
-      size_t const object_size = sizeof(TObject);
-      size_t const chunk_bytes = 4096;
-      return std::max<size_t>(chunk_bytes / object_size, 1);
-    }();
+    used_bitset used = {};
 
-    std::array<object_type, chunk_size> objects = {};
-    static_bitset<chunk_size> used = {};
+    // initialized by add_chunk
+    std::array<object_type, chunk_size> objects;
 
     constexpr size_t size() const { return objects.size(); }
 
@@ -116,16 +243,101 @@ private:
       return had_none_available;
     }
 
+    template <typename OutputIt>
+    constexpr auto acquire_n(size_t const count, OutputIt output) {
+      using word_type = typename used_bitset::chunk_type;
+      constexpr size_t word_bits = used_bitset::bits_per_chunk();
+
+      size_t acquired = 0;
+      for (size_t word_index = used.countr_one() / word_bits;
+           word_index < used.count_chunks() and acquired < count;
+           ++word_index) {
+        auto word = used.get_chunk(word_index);
+        auto free =
+            ~word & used_bitset::get_chunk_mask_of_valid_bits(word_index);
+
+        while (free != 0 and acquired < count) {
+          size_t const first = std::countr_zero(free);
+          size_t const run = std::min<size_t>(
+              std::countr_one(static_cast<word_type>(free >> first)),
+              count - acquired);
+
+          word_type const run_mask =
+              run == word_bits ? ~word_type{0}
+                               : ((word_type{1} << run) - 1) << first;
+          word |= run_mask;
+          free &= ~run_mask;
+
+          auto *object = &objects[word_index * word_bits + first];
+          for (size_t offset = 0; offset < run; ++offset)
+            *(output++) = object + offset;
+          acquired += run;
+        }
+
+        used.set_chunk(word_index, word);
+      }
+
+      return std::make_tuple(acquired, output, used.all());
+    }
+
     constexpr size_t count_used_objects() const {
       return used.count_set_bits();
     }
   };
 
+  static_assert(chunk_size == 1 or sizeof(chunk_type) <= NChunkBytes);
+
+  struct chunk_deleter {
+    void operator()(chunk_type *chunk) const {
+      chunk->~chunk_type();
+      chunk_memory::deallocate(chunk, sizeof(chunk_type), alignof(chunk_type));
+    }
+  };
+
+  using chunk_ptr = std::unique_ptr<chunk_type, chunk_deleter>;
+
+private:
+  // chunks_ is kept sorted by address so that find_chunk is a binary search
+  void add_chunk() {
+    auto *memory =
+        chunk_memory::allocate(sizeof(chunk_type), alignof(chunk_type));
+    chunk_ptr chunk{
+        default_initialize_pool_objects<TObject> ? new (memory) chunk_type
+                                                 : new (memory) chunk_type{}};
+    available_chunks_.emplace_back(chunk.get());
+
+    auto it = std::upper_bound(
+        chunks_.begin(), chunks_.end(), chunk.get(),
+        [](chunk_type const *lhs, auto const &rhs) {
+          return std::less<chunk_type const *>{}(lhs, rhs.get());
+        });
+    chunks_.insert(it, std::move(chunk));
+  }
+
+  chunk_type *find_chunk(TObject *object) {
+    auto it = std::upper_bound(
+        chunks_.begin(), chunks_.end(), object,
+        [](TObject const *lhs, auto const &rhs) {
+          return std::less<TObject const *>{}(lhs, rhs->objects.data());
+        });
+
+    if (it == chunks_.begin() or not(*std::prev(it))->contains(object)) {
+      assert(not "object was not contained in any chunk");
+      return nullptr;
+    }
+    return std::prev(it)->get();
+  }
+
 private:
-  std::vector<std::unique_ptr<chunk_type>> chunks_;
+  std::vector<chunk_ptr> chunks_;
   std::vector<chunk_type *> available_chunks_;
 };
 
+template <typename TObject>
+using huge_page_object_pool =
+    object_pool<TObject, huge_page_chunk_memory::huge_page_bytes,
+                huge_page_chunk_memory>;
+
 template <typename TObject>
 object_pool<TObject> &get_object_pool() {
   static auto the_pool = std::make_unique<object_pool<TObject>>();
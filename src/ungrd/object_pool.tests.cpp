@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include "cxx/set.hpp"
+#include "object_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <cstring>
+
+using namespace ungrd;
+
+TEST(ObjectPool, AcquireNReleaseN) {
+  using object_type = std::array<char, 16>;
+
+  object_pool<object_type> pool;
+
+  std::vector<object_type *> objects;
+  pool.acquire_n(1000, std::back_inserter(objects));
+  ASSERT_EQ(1000, objects.size());
+
+  {
+    hash_set<object_type *> distinct{objects.begin(), objects.end()};
+    ASSERT_EQ(1000, distinct.size());
+  }
+
+  // runs within a chunk are contiguous
+  ASSERT_EQ(objects[0] + 1, objects[1]);
+
+  auto const available = pool.count_available_objects();
+
+  // release every other object, some of them one by one
+  std::vector<object_type *> released;
+  for (size_t index = 0; index < objects.size(); index += 2)
+    released.emplace_back(objects[index]);
+  pool.release_n(released);
+  pool.release(objects[1]);
+  pool.release(objects[3]);
+  ASSERT_EQ(available + 502, pool.count_available_objects());
+
+  std::vector<object_type *> reacquired;
+  pool.acquire_n(502, std::back_inserter(reacquired));
+  ASSERT_EQ(available, pool.count_available_objects());
+
+  {
+    hash_set<object_type *> distinct{reacquired.begin(), reacquired.end()};
+    ASSERT_EQ(502, distinct.size());
+    ASSERT_TRUE(distinct.contains(objects[1]));
+    ASSERT_TRUE(distinct.contains(objects[3]));
+    for (auto *object : released)
+      ASSERT_TRUE(distinct.contains(object));
+  }
+
+  pool.release_n(reacquired);
+  for (size_t index = 5; index < objects.size(); index += 2)
+    pool.release(objects[index]);
+  ASSERT_EQ(
+      pool.count_chunks() * pool.objects_per_chunk,
+      pool.count_available_objects());
+  ASSERT_EQ(pool.count_chunks(), pool.count_available_chunks());
+}
+
+namespace {
+
+// chunk memory that is filled with garbage
+struct dirty_chunk_memory {
+  static void *allocate(size_t const bytes, size_t const alignment) {
+    auto *memory = heap_chunk_memory::allocate(bytes, alignment);
+    std::memset(memory, 0xab, bytes);
+    return memory;
+  }
+
+  static void
+  deallocate(void *const memory, size_t const bytes, size_t const alignment) {
+    heap_chunk_memory::deallocate(memory, bytes, alignment);
+  }
+};
+
+} // namespace
+
+TEST(ObjectPool, ValueInitializesObjects) {
+  object_pool<std::array<int, 4>, 4096, dirty_chunk_memory> pool;
+
+  std::vector<std::array<int, 4> *> objects;
+  pool.acquire_n(pool.objects_per_chunk, std::back_inserter(objects));
+  for (auto const *object : objects)
+    ASSERT_EQ((std::array<int, 4>{}), *object);
+}
+
+TEST(ObjectPool, Trim) {
+  using object_type = std::array<char, 64>;
+
+  object_pool<object_type> pool;
+
+  std::vector<object_type *> objects;
+  pool.acquire_n(10 * pool.objects_per_chunk, std::back_inserter(objects));
+  ASSERT_EQ(10, pool.count_chunks());
+
+  // keep a single object alive in the first and the last chunk
+  pool.release_n(
+      std::vector<object_type *>(objects.begin() + 1, objects.end() - 1));
+  ASSERT_EQ(10, pool.count_chunks());
+
+  auto const report = pool.count_available_objects_per_chunk();
+  ASSERT_EQ(10, report.size());
+  ASSERT_EQ(
+      2, std::count(
+             report.begin(), report.end(), pool.objects_per_chunk - 1));
+  ASSERT_EQ(
+      8, std::count(report.begin(), report.end(), pool.objects_per_chunk));
+
+  ASSERT_EQ(8, pool.trim());
+  ASSERT_EQ(2, pool.count_chunks());
+  ASSERT_EQ(2, pool.count_available_chunks());
+  ASSERT_EQ(2 * pool.objects_per_chunk - 2, pool.count_available_objects());
+
+  pool.release(objects.front());
+  pool.release(objects.back());
+  ASSERT_EQ(2, pool.trim());
+  ASSERT_EQ(0, pool.count_chunks());
+  ASSERT_EQ(0, pool.count_available_chunks());
+}
+
+TEST(ObjectPool, HugePageChunks) {
+  using object_type = std::array<char, 64>;
+
+  huge_page_object_pool<object_type> pool;
+  ASSERT_LT(4096 / sizeof(object_type), pool.objects_per_chunk);
+
+  std::vector<object_type *> objects;
+  pool.acquire_n(pool.objects_per_chunk + 1, std::back_inserter(objects));
+  ASSERT_EQ(2, pool.count_chunks());
+
+  for (auto *object : objects)
+    object->fill(1);
+
+  pool.release_n(objects);
+  ASSERT_EQ(2, pool.trim());
+}
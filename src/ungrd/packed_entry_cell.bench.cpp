@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+
+#include "compact_grid.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace ungrd;
+
+namespace {
+
+std::size_t allocated_bytes = 0;
+
+// Counts the bytes of the entry arrays of the cells.
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+
+  counting_allocator() = default;
+  template <typename U>
+  counting_allocator(counting_allocator<U> const &) {}
+
+  T *allocate(std::size_t const n) {
+    allocated_bytes += n * sizeof(T);
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T *const p, std::size_t const n) {
+    allocated_bytes -= n * sizeof(T);
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  template <typename U>
+  bool operator==(counting_allocator<U> const &) const {
+    return true;
+  }
+};
+
+using position_type = std::array<int, 3>;
+
+// range(0) entries per cell on average in 64^3 cells. The entries are numbered
+// in the order of their cells, like particles that were sorted by cell, or in
+// random order if range(1) is 0.
+auto const &Packed_Input(benchmark::State &state) {
+  static std::vector<std::pair<position_type, std::uint32_t>> input;
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{0, 63};
+
+  input.resize(64 * 64 * 64 * state.range(0));
+  for (auto &[cpos, entry] : input)
+    for (auto &coordinate : cpos)
+      coordinate = coordinate_dis(gen);
+
+  if (state.range(1) != 0)
+    std::sort(input.begin(), input.end());
+
+  for (std::uint32_t entry = 0; entry < input.size(); ++entry)
+    input[entry].second = entry;
+
+  return input;
+}
+
+} // namespace
+
+// Updates the grid and reports the bytes of the entry arrays per entry. Plain
+// cells reserve room for 50 entries when they are created.
+template <typename PEntry>
+void BMT_CompactGrid_EntryMemory(benchmark::State &state) {
+  using grid_type = compact_grid<
+      s32_space_policy<3>, PEntry,
+      counting_allocator<typename PEntry::entry>>;
+
+  auto const &input = Packed_Input(state);
+
+  for (auto _ : state) {
+    grid_type grid;
+    grid.update(input);
+
+    state.PauseTiming();
+    state.counters["bytes_per_entry"] =
+        static_cast<double>(allocated_bytes) / input.size();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK_TEMPLATE(BMT_CompactGrid_EntryMemory, u32_entry_policy)
+    ->ArgsProduct({{4, 16}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BMT_CompactGrid_EntryMemory, u32_packed_entry_policy)
+    ->ArgsProduct({{4, 16}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// Visits every entry of the grid, decoding the packed cells on the fly.
+template <typename PEntry>
+void BMT_CompactGrid_SumAllEntries(benchmark::State &state) {
+  using grid_type = compact_grid<s32_space_policy<3>, PEntry>;
+
+  auto const &input = Packed_Input(state);
+
+  grid_type grid;
+  grid.update(input);
+
+  std::uint64_t sum = 0;
+  for (auto _ : state) {
+    grid.foreach_entry_in_box(
+        {0, 0, 0}, {63, 63, 63}, [&sum](auto const entry) { sum += entry; });
+  }
+  benchmark::DoNotOptimize(sum);
+
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK_TEMPLATE(BMT_CompactGrid_SumAllEntries, u32_entry_policy)
+    ->ArgsProduct({{4, 16}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BMT_CompactGrid_SumAllEntries, u32_packed_entry_policy)
+    ->ArgsProduct({{4, 16}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,229 @@
+#ifndef UNGRD_PACKED_ENTRY_CELL_HPP_93E15D9BE26D49059FE5C7ED726DBF61
+#define UNGRD_PACKED_ENTRY_CELL_HPP_93E15D9BE26D49059FE5C7ED726DBF61
+
+#include "cxx/narrow.hpp"
+
+#include "entry_policy.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ungrd {
+
+// The entries of a cell, sorted and delta encoded into a byte vector:
+//
+//   count, first entry as LEB128 varints
+//   width, one byte
+//   count - 1 gaps between consecutive entries minus one, width bits each,
+//   packed least significant bit first
+//
+// Consecutive entries have a gap of 0, so the cells of entries that were
+// sorted by cell need only the header. All gaps of a cell have the same width,
+// unlike varints they are decoded without a branch per byte. Adding and erasing
+// an entry decodes and encodes the whole cell, the cost is linear in its size
+// like the search for duplicates in entry_cell.
+template <typename PEntry, typename TAllocator>
+class packed_entry_cell {
+  using entry_type = typename PEntry::entry;
+
+  static_assert(std::is_unsigned_v<entry_type>);
+  static_assert(
+      std::is_void_v<typename PEntry::payload>,
+      "payloads are not stored in packed cells");
+
+  using byte_allocator = typename std::allocator_traits<
+      TAllocator>::template rebind_alloc<std::uint8_t>;
+  using byte_vector = std::vector<std::uint8_t, byte_allocator>;
+
+public:
+  bool empty() const { return bytes_.empty(); }
+
+  size_t size() const {
+    if (bytes_.empty())
+      return 0;
+    auto const *p = bytes_.data();
+    return static_cast<size_t>(read_varint(p));
+  }
+
+  // the encoded entries
+  std::span<std::uint8_t const> bytes() const { return bytes_; }
+
+  // Calls callback(entry) for every entry in ascending order.
+  template <typename FCallback>
+  void foreach_entry(FCallback callback) const {
+    if (bytes_.empty())
+      return;
+
+    auto const *p = bytes_.data();
+    auto const count = read_varint(p);
+    auto entry = static_cast<entry_type>(read_varint(p));
+    unsigned const width = *p++;
+
+    callback(entry);
+
+    // consecutive entries
+    if (width == 0) {
+      for (std::uint64_t i = 1; i < count; ++i)
+        callback(++entry);
+      return;
+    }
+
+    bit_reader reader{p};
+    for (std::uint64_t i = 1; i < count; ++i) {
+      entry += static_cast<entry_type>(reader.read(width)) + 1;
+      callback(entry);
+    }
+  }
+
+public:
+  // Packed cells are always sized to fit their entries.
+  void reserve_entries(size_t) {}
+
+  void clear_entries() { bytes_.clear(); }
+
+  void add_entry(entry_type entry) {
+    auto &entries = decode();
+    auto it = std::lower_bound(entries.begin(), entries.end(), entry);
+    if (it == entries.end() or *it != entry) {
+      entries.insert(it, entry);
+      encode(entries);
+    }
+  }
+
+  // adds the entry of an input element (cpos, entry)
+  template <typename TElement>
+  void add_input_entry(TElement const &element) {
+    add_entry(narrow<entry_type>(std::get<1>(element)));
+  }
+
+  void erase_entry(entry_type entry) {
+    auto &entries = decode();
+    auto it = std::lower_bound(entries.begin(), entries.end(), entry);
+    if (it != entries.end() and *it == entry) {
+      entries.erase(it);
+      encode(entries);
+    }
+  }
+
+  friend void swap(packed_entry_cell &a, packed_entry_cell &b) {
+    using std::swap;
+    swap(a.bytes_, b.bytes_);
+  }
+
+private:
+  // the entries of the cell in a scratch vector that is reused by all cells of
+  // a thread
+  std::vector<entry_type> &decode() const {
+    thread_local std::vector<entry_type> entries;
+    entries.clear();
+    foreach_entry([](entry_type const entry) { entries.push_back(entry); });
+    return entries;
+  }
+
+  void encode(std::vector<entry_type> const &entries) {
+    bytes_.clear();
+    if (entries.empty())
+      return;
+
+    entry_type max_gap = 0;
+    for (size_t i = 1; i < entries.size(); ++i)
+      max_gap =
+          std::max<entry_type>(max_gap, entries[i] - entries[i - 1] - 1);
+    auto const width = static_cast<unsigned>(std::bit_width(max_gap));
+
+    write_varint(entries.size());
+    write_varint(entries.front());
+    bytes_.push_back(static_cast<std::uint8_t>(width));
+
+    std::uint64_t buffer = 0;
+    unsigned buffered = 0;
+    auto const write = [&](std::uint64_t value, unsigned bits) {
+      // bits is at most 32, the buffer holds less than 8 bits before
+      buffer |= value << buffered;
+      buffered += bits;
+      for (; buffered >= 8; buffered -= 8, buffer >>= 8)
+        bytes_.push_back(static_cast<std::uint8_t>(buffer));
+    };
+
+    for (size_t i = 1; i < entries.size(); ++i) {
+      std::uint64_t const gap = entries[i] - entries[i - 1] - 1;
+      if (width <= 32) {
+        write(gap, width);
+      } else {
+        write(gap & 0xFFFF'FFFF, 32);
+        write(gap >> 32, width - 32);
+      }
+    }
+    if (buffered > 0)
+      bytes_.push_back(static_cast<std::uint8_t>(buffer));
+  }
+
+  void write_varint(std::uint64_t value) {
+    while (value >= 0x80) {
+      bytes_.push_back(static_cast<std::uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    bytes_.push_back(static_cast<std::uint8_t>(value));
+  }
+
+  static std::uint64_t read_varint(std::uint8_t const *&p) {
+    std::uint64_t value = 0;
+    for (unsigned shift = 0;; shift += 7) {
+      auto const byte = *p++;
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if (byte < 0x80)
+        return value;
+    }
+  }
+
+  // reads values of up to 64 bits written by encode
+  struct bit_reader {
+    std::uint8_t const *p;
+    std::uint64_t buffer = 0;
+    unsigned buffered = 0;
+
+    std::uint64_t read(unsigned const bits) {
+      if (bits <= 32)
+        return read_word(bits);
+      auto const lo = read_word(32);
+      return lo | read_word(bits - 32) << 32;
+    }
+
+    std::uint64_t read_word(unsigned const bits) {
+      while (buffered < bits) {
+        buffer |= static_cast<std::uint64_t>(*p++) << buffered;
+        buffered += 8;
+      }
+      auto const value = buffer & ((std::uint64_t{1} << bits) - 1);
+      buffer >>= bits;
+      buffered -= bits;
+      return value;
+    }
+  };
+
+public:
+  packed_entry_cell() = default;
+
+  explicit packed_entry_cell(TAllocator const &allocator)
+      : bytes_{byte_allocator{allocator}} {}
+
+  // Moves the bytes of other into memory from allocator.
+  packed_entry_cell(packed_entry_cell &&other, TAllocator const &allocator)
+      : bytes_{std::move(other.bytes_), byte_allocator{allocator}} {}
+
+private:
+  byte_vector bytes_ = {};
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_PACKED_ENTRY_CELL_HPP_93E15D9BE26D49059FE5C7ED726DBF61
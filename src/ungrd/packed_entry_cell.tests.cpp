@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "packed_entry_cell.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace ungrd;
+
+namespace {
+
+// Adds and erases random entries and compares the cell with a std::set.
+template <typename TEntry>
+void T_PackedEntryCell_Random(TEntry const max_entry) {
+  using cell_type =
+      packed_entry_cell<packed_entry_policy<TEntry>, std::allocator<TEntry>>;
+
+  std::mt19937_64 gen{0};
+  std::uniform_int_distribution<TEntry> entry_dis{0, max_entry};
+
+  cell_type cell;
+  std::set<TEntry> expected;
+
+  auto const check = [&] {
+    std::vector<TEntry> entries;
+    cell.foreach_entry(
+        [&entries](TEntry const entry) { entries.push_back(entry); });
+    ASSERT_EQ(std::vector<TEntry>(expected.begin(), expected.end()), entries);
+    ASSERT_EQ(expected.size(), cell.size());
+    ASSERT_EQ(expected.empty(), cell.empty());
+  };
+
+  for (size_t round = 0; round < 2000; ++round) {
+    auto const entry = entry_dis(gen);
+    if (round % 3 == 2) {
+      cell.erase_entry(entry);
+      expected.erase(entry);
+      // erase one that is there
+      if (not expected.empty()) {
+        auto const present = *expected.begin();
+        cell.erase_entry(present);
+        expected.erase(present);
+      }
+    } else {
+      cell.add_entry(entry);
+      cell.add_entry(entry);
+      expected.insert(entry);
+    }
+    check();
+  }
+
+  cell.clear_entries();
+  expected.clear();
+  check();
+}
+
+} // namespace
+
+TEST(PackedEntryCell, U32Random) {
+  T_PackedEntryCell_Random<std::uint32_t>(
+      std::numeric_limits<std::uint32_t>::max());
+}
+
+TEST(PackedEntryCell, U32Dense) {
+  T_PackedEntryCell_Random<std::uint32_t>(300);
+}
+
+TEST(PackedEntryCell, U64Random) {
+  T_PackedEntryCell_Random<std::uint64_t>(
+      std::numeric_limits<std::uint64_t>::max());
+}
+
+TEST(PackedEntryCell, ConsecutiveEntries) {
+  using cell_type = packed_entry_cell<u32_packed_entry_policy,
+                                      std::allocator<std::uint32_t>>;
+
+  cell_type cell;
+  for (std::uint32_t entry = 1000; entry < 1100; ++entry)
+    cell.add_entry(entry);
+
+  // count, first entry and a width of 0
+  ASSERT_EQ(1u + 2u + 1u, cell.bytes().size());
+  ASSERT_EQ(100u, cell.size());
+
+  std::uint32_t next = 1000;
+  cell.foreach_entry([&next](auto const entry) { ASSERT_EQ(next++, entry); });
+  ASSERT_EQ(1100u, next);
+}
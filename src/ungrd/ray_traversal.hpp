@@ -0,0 +1,169 @@
+#ifndef UNGRD_RAY_TRAVERSAL_HPP_38E05EF2572A4E1D8B9AC9E572570C92
+#define UNGRD_RAY_TRAVERSAL_HPP_38E05EF2572A4E1D8B9AC9E572570C92
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <utility>
+
+#include <cstddef>
+
+namespace ungrd {
+
+// Steps through the cells that the segment origin + t * direction, t in
+// [0, t_max], passes through inside the inclusive box of cells [lo, hi], in
+// order of increasing t. Coordinates are in units of the cell size, the cell
+// cpos covers [cpos, cpos + 1). This is the algorithm by Amanatides and Woo,
+// the segment is clipped to the box first.
+template <typename TPosition, typename TReal>
+class ray_traversal {
+  static constexpr size_t ndim = std::tuple_size_v<TPosition>;
+  using position_index_type = typename TPosition::value_type;
+
+  static constexpr TReal infinity = std::numeric_limits<TReal>::infinity();
+
+public:
+  using point_type = std::array<TReal, ndim>;
+
+public:
+  // false if the segment misses the box or all cells were visited
+  bool valid() const { return valid_; }
+
+  TPosition const &cpos() const { return cpos_; }
+
+  // the segment parameters where the segment enters and exits the cell
+  TReal t_enter() const { return t_enter_; }
+  TReal t_exit() const { return std::min(t_next_[next_dim()], t_end_); }
+
+  // the dimension and direction (-1 or 1) of the last step
+  size_t step_dim() const { return step_dim_; }
+  position_index_type step_sign() const { return step_[step_dim_]; }
+
+public:
+  // Advances to the next cell, returns false once the segment leaves the box
+  // or ends.
+  bool step() {
+    auto const dim = next_dim();
+    if (not(t_next_[dim] <= t_end_) or cpos_[dim] == bound_[dim]) {
+      valid_ = false;
+      return false;
+    }
+
+    t_enter_ = t_next_[dim];
+    t_next_[dim] += t_delta_[dim];
+    cpos_[dim] += step_[dim];
+    step_dim_ = dim;
+    return true;
+  }
+
+private:
+  size_t next_dim() const {
+    size_t dim = 0;
+    for (size_t other_dim = 1; other_dim < ndim; ++other_dim)
+      if (t_next_[other_dim] < t_next_[dim])
+        dim = other_dim;
+    return dim;
+  }
+
+public:
+  ray_traversal(
+      point_type const &origin, point_type const &direction, TReal const t_max,
+      TPosition const &lo, TPosition const &hi) {
+    TReal t_begin = 0, t_end = t_max;
+
+    // clip the segment to the box
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      if (lo[dim] > hi[dim])
+        return;
+
+      auto const box_lo = static_cast<TReal>(lo[dim]);
+      auto const box_hi = static_cast<TReal>(hi[dim]) + 1;
+
+      if (direction[dim] == 0) {
+        if (origin[dim] < box_lo or not(origin[dim] < box_hi))
+          return;
+      } else {
+        auto t0 = (box_lo - origin[dim]) / direction[dim];
+        auto t1 = (box_hi - origin[dim]) / direction[dim];
+        if (t0 > t1)
+          std::swap(t0, t1);
+        t_begin = std::max(t_begin, t0);
+        t_end = std::min(t_end, t1);
+      }
+    }
+
+    if (not(t_begin <= t_end))
+      return;
+
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      auto const point = origin[dim] + t_begin * direction[dim];
+      auto const cell = std::clamp<TReal>(
+          std::floor(point), static_cast<TReal>(lo[dim]),
+          static_cast<TReal>(hi[dim]));
+      cpos_[dim] = static_cast<position_index_type>(cell);
+
+      if (direction[dim] > 0) {
+        step_[dim] = 1;
+        bound_[dim] = hi[dim];
+        t_next_[dim] = (cell + 1 - origin[dim]) / direction[dim];
+        t_delta_[dim] = 1 / direction[dim];
+      } else if (direction[dim] < 0) {
+        step_[dim] = -1;
+        bound_[dim] = lo[dim];
+        t_next_[dim] = (cell - origin[dim]) / direction[dim];
+        t_delta_[dim] = -1 / direction[dim];
+      } else {
+        step_[dim] = 0;
+        bound_[dim] = cpos_[dim];
+        t_next_[dim] = infinity;
+        t_delta_[dim] = infinity;
+      }
+    }
+
+    t_enter_ = t_begin;
+    t_end_ = t_end;
+    valid_ = true;
+  }
+
+private:
+  bool valid_ = false;
+
+  TPosition cpos_ = {};
+  TPosition step_ = {};
+  TPosition bound_ = {};
+  size_t step_dim_ = 0;
+
+  TReal t_enter_ = 0;
+  TReal t_end_ = 0;
+  point_type t_next_ = {};
+  point_type t_delta_ = {};
+};
+
+// Calls grid.foreach_cell_along_ray for every ray in parallel. The callback is
+// called as callback(ray, cpos, t_enter, t_exit, entries) and returns false to
+// stop the traversal of that ray.
+template <
+    typename TGrid, typename TPoints, typename TReals, typename FCallback>
+void foreach_cell_along_rays(
+    TGrid const &grid, TPoints const &origins, TPoints const &directions,
+    TReals const &t_maxes, FCallback callback) {
+  using std::size;
+  size_t const ray_count = size(origins);
+
+#pragma omp parallel for schedule(dynamic, 16)
+  for (size_t ray = 0; ray < ray_count; ++ray) {
+    grid.foreach_cell_along_ray(
+        origins[ray], directions[ray], t_maxes[ray],
+        [&callback, ray](
+            auto const &cpos, auto const t_enter, auto const t_exit,
+            auto const &entries) {
+          return callback(ray, cpos, t_enter, t_exit, entries);
+        });
+  }
+}
+
+} // namespace ungrd
+
+#endif // UNGRD_RAY_TRAVERSAL_HPP_38E05EF2572A4E1D8B9AC9E572570C92
@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "fixed_dense_grid.hpp"
+#include "ray_traversal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace ungrd;
+
+namespace {
+
+using point_type = std::array<double, 3>;
+using position_type = std::array<int, 3>;
+
+position_type point_to_cpos(point_type const &point) {
+  position_type cpos;
+  for (size_t dim = 0; dim < 3; ++dim)
+    cpos[dim] = static_cast<int>(std::floor(point[dim]));
+  return cpos;
+}
+
+point_type point_along(
+    point_type const &origin, point_type const &direction, double const t) {
+  point_type point;
+  for (size_t dim = 0; dim < 3; ++dim)
+    point[dim] = origin[dim] + t * direction[dim];
+  return point;
+}
+
+// the segment parameters where the segment overlaps the cell, if it does
+bool segment_hits_cell(
+    point_type const &origin, point_type const &direction, double const t_max,
+    position_type const &cpos) {
+  double t_begin = 0, t_end = t_max;
+  for (size_t dim = 0; dim < 3; ++dim) {
+    double const lo = cpos[dim], hi = cpos[dim] + 1;
+    if (direction[dim] == 0) {
+      if (origin[dim] < lo or origin[dim] >= hi)
+        return false;
+    } else {
+      auto t0 = (lo - origin[dim]) / direction[dim];
+      auto t1 = (hi - origin[dim]) / direction[dim];
+      if (t0 > t1)
+        std::swap(t0, t1);
+      t_begin = std::max(t_begin, t0);
+      t_end = std::min(t_end, t1);
+    }
+  }
+  return t_begin <= t_end;
+}
+
+struct random_segments {
+  std::vector<point_type> origins, directions;
+  std::vector<double> t_maxes;
+
+  explicit random_segments(size_t const count) {
+    std::mt19937 gen{0};
+    std::uniform_real_distribution<double> origin_dis{-12., 12.};
+    std::uniform_real_distribution<double> direction_dis{-1., 1.};
+    std::uniform_real_distribution<double> t_max_dis{0., 30.};
+
+    for (size_t segment = 0; segment < count; ++segment) {
+      point_type origin, direction;
+      for (size_t dim = 0; dim < 3; ++dim) {
+        origin[dim] = origin_dis(gen);
+        direction[dim] = direction_dis(gen);
+      }
+      // some axis aligned segments
+      if (segment % 5 == 0)
+        direction[segment % 3] = 0;
+      if (segment % 10 == 0)
+        direction[(segment + 1) % 3] = 0;
+
+      origins.push_back(origin);
+      directions.push_back(direction);
+      t_maxes.push_back(t_max_dis(gen));
+    }
+  }
+};
+
+// The cells are spread apart by spread cells along every axis.
+template <typename Grid>
+void T_Grid_ForeachCellAlongRay(int const spread = 1) {
+  using grid_position_type = typename Grid::space_policy::position;
+  using entry_type = typename Grid::entry_policy::entry;
+
+  std::mt19937 gen{1};
+  std::uniform_int_distribution<int> coordinate_dis{-6, 6};
+
+  Grid grid;
+  std::vector<std::pair<grid_position_type, entry_type>> input;
+  for (entry_type entry = 0; entry < 400; ++entry) {
+    grid_position_type cpos;
+    for (size_t dim = 0; dim < 3; ++dim)
+      cpos[dim] = static_cast<typename grid_position_type::value_type>(
+          spread * coordinate_dis(gen));
+    input.emplace_back(cpos, entry);
+  }
+  grid.update(input);
+
+  std::vector<grid_position_type> filled_cells;
+  grid.foreach_position(
+      [&filled_cells](auto const &cpos) { filled_cells.push_back(cpos); });
+
+  random_segments const segments{500};
+
+  std::vector<std::vector<grid_position_type>> visited_per_segment;
+  for (size_t segment = 0; segment < segments.origins.size(); ++segment) {
+    auto const &origin = segments.origins[segment];
+    auto const &direction = segments.directions[segment];
+    auto const t_max = segments.t_maxes[segment];
+
+    std::vector<grid_position_type> visited;
+    double last_t_exit = 0;
+    grid.foreach_cell_along_ray(
+        origin, direction, t_max,
+        [&](auto const &cpos, double const t_enter, double const t_exit,
+            auto const &entries) {
+          EXPECT_LE(last_t_exit, t_enter);
+          EXPECT_LE(t_enter, t_exit);
+          last_t_exit = t_exit;
+
+          EXPECT_FALSE(entries.empty());
+          for (auto const entry : entries)
+            EXPECT_EQ(input[entry].first, cpos);
+
+          visited.push_back(cpos);
+          return true;
+        });
+
+    std::vector<grid_position_type> expected;
+    for (auto const &cpos : filled_cells)
+      if (segment_hits_cell(
+              origin, direction, t_max, {cpos[0], cpos[1], cpos[2]}))
+        expected.push_back(cpos);
+
+    auto sorted_visited = visited;
+    std::sort(sorted_visited.begin(), sorted_visited.end());
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(expected, sorted_visited);
+
+    // early exit
+    size_t call_count = 0;
+    grid.foreach_cell_along_ray(
+        origin, direction, t_max,
+        [&call_count](auto const &, double, double, auto const &) {
+          ++call_count;
+          return false;
+        });
+    ASSERT_EQ(std::min<size_t>(1, visited.size()), call_count);
+
+    visited_per_segment.push_back(std::move(visited));
+  }
+
+  // the batched traversal visits the same cells
+  std::vector<std::vector<grid_position_type>> batch_visited_per_segment(
+      segments.origins.size());
+  foreach_cell_along_rays(
+      grid, segments.origins, segments.directions, segments.t_maxes,
+      [&](size_t const segment, auto const &cpos, double, double,
+          auto const &) {
+        batch_visited_per_segment[segment].push_back(cpos);
+        return true;
+      });
+  ASSERT_EQ(visited_per_segment, batch_visited_per_segment);
+}
+
+} // namespace
+
+TEST(RayTraversal, VisitsConnectedCellsAlongSegment) {
+  position_type const lo{-8, -8, -8}, hi{8, 8, 8};
+
+  random_segments const segments{1000};
+  for (size_t segment = 0; segment < segments.origins.size(); ++segment) {
+    auto const &origin = segments.origins[segment];
+    auto const &direction = segments.directions[segment];
+    auto const t_max = segments.t_maxes[segment];
+
+    std::vector<position_type> visited;
+    for (ray_traversal<position_type, double> ray{
+             origin, direction, t_max, lo, hi};
+         ray.valid(); ray.step()) {
+      auto const &cpos = ray.cpos();
+      for (size_t dim = 0; dim < 3; ++dim) {
+        ASSERT_LE(lo[dim], cpos[dim]);
+        ASSERT_LE(cpos[dim], hi[dim]);
+      }
+      ASSERT_TRUE(segment_hits_cell(origin, direction, t_max, cpos));
+
+      // the middle of the cell's interval lies in the cell
+      auto const t = (ray.t_enter() + ray.t_exit()) / 2;
+      ASSERT_EQ(cpos, point_to_cpos(point_along(origin, direction, t)));
+
+      // consecutive cells are face neighbours
+      if (not visited.empty()) {
+        int distance = 0;
+        for (size_t dim = 0; dim < 3; ++dim)
+          distance += std::abs(cpos[dim] - visited.back()[dim]);
+        ASSERT_EQ(1, distance);
+      }
+      visited.push_back(cpos);
+    }
+
+    // every point of the segment inside of the box is in a visited cell
+    for (size_t sample = 0; sample <= 1000; ++sample) {
+      auto const t = t_max * sample / 1000;
+      auto const cpos = point_to_cpos(point_along(origin, direction, t));
+
+      bool inside = true;
+      for (size_t dim = 0; dim < 3; ++dim)
+        inside = inside and lo[dim] <= cpos[dim] and cpos[dim] <= hi[dim];
+
+      if (inside) {
+        ASSERT_NE(
+            visited.end(), std::find(visited.begin(), visited.end(), cpos));
+      }
+    }
+  }
+}
+
+TEST(RayTraversal, DenseGrid) {
+  T_Grid_ForeachCellAlongRay<s32_e32_dense_grid<3>>();
+}
+
+TEST(RayTraversal, FixedDenseGrid) {
+  T_Grid_ForeachCellAlongRay<s32_e32_fixed_dense_grid<16, 16, 16>>();
+}
+
+TEST(RayTraversal, CompactGrid) {
+  T_Grid_ForeachCellAlongRay<s32_e32_compact_grid<3>>();
+}
+
+// most blocks of cells along the segments are empty
+TEST(RayTraversal, SparseCompactGrid) {
+  T_Grid_ForeachCellAlongRay<s32_e32_compact_grid<3>>(5);
+}
+
+TEST(RayTraversal, S16E16DenseGrid) {
+  T_Grid_ForeachCellAlongRay<s16_e16_dense_grid<3>>();
+}
+
+TEST(RayTraversal, S16E16FixedDenseGrid) {
+  T_Grid_ForeachCellAlongRay<fixed_dense_grid<
+      s16_space_policy<3>, u16_entry_policy,
+      static_lexicographic_indexing<16, 16, 16>>>();
+}
+
+TEST(RayTraversal, S16E16CompactGrid) {
+  T_Grid_ForeachCellAlongRay<s16_e16_compact_grid<3>>();
+}
@@ -0,0 +1,166 @@
+#ifndef UNGRD_SLAB_MEMORY_RESOURCE_HPP_5C1E9E272D7746B39441D6927A3745D0
+#define UNGRD_SLAB_MEMORY_RESOURCE_HPP_5C1E9E272D7746B39441D6927A3745D0
+
+#include "cxx/map.hpp"
+#include "object_pool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <memory_resource>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+
+namespace ungrd {
+
+template <size_t NBytes>
+struct alignas(std::max_align_t) slab_block {
+  std::byte bytes[NBytes];
+};
+
+// blocks are raw memory, zeroing them would touch every page of a new chunk
+template <size_t NBytes>
+inline constexpr bool default_initialize_pool_objects<slab_block<NBytes>> =
+    true;
+
+// Memory resource serving small allocations from object pools of power of two
+// size classes (16 bytes up to 2 KiB). Larger or over-aligned allocations are
+// forwarded to the upstream resource.
+//
+// release() frees all memory at once, which makes it possible to drop all cell
+// storage of a grid at a frame boundary. Grids using the resource must be
+// cleared or destroyed before calling release().
+class slab_memory_resource : public std::pmr::memory_resource {
+  static constexpr size_t min_block_bytes = 16;
+  static constexpr size_t max_block_bytes = 2048;
+
+  static constexpr size_t class_count =
+      std::bit_width(max_block_bytes) - std::bit_width(min_block_bytes) + 1;
+
+  // chunks hold at least about 32 blocks, so that the bitset in the chunk
+  // wastes little memory for the large size classes
+  static constexpr size_t min_chunk_blocks = 32;
+
+  template <size_t NBytes>
+  using pool_for = object_pool<
+      slab_block<NBytes>, std::max<size_t>(4096, min_chunk_blocks * NBytes)>;
+
+  template <size_t... IClass>
+  static auto make_pools(std::index_sequence<IClass...>)
+      -> std::tuple<pool_for<(min_block_bytes << IClass)>...>;
+
+  using pools_type =
+      decltype(make_pools(std::make_index_sequence<class_count>{}));
+
+  static_assert(
+      pool_for<max_block_bytes>::objects_per_chunk == min_chunk_blocks - 1);
+
+  static constexpr size_t get_class_index(size_t const bytes) {
+    auto const block_bytes = std::bit_ceil(std::max(bytes, min_block_bytes));
+    return std::bit_width(block_bytes) - std::bit_width(min_block_bytes);
+  }
+
+  static constexpr bool is_slab_allocation(
+      size_t const bytes, size_t const alignment) {
+    return bytes <= max_block_bytes and alignment <= alignof(std::max_align_t);
+  }
+
+  template <typename FCallback, size_t... IClass>
+  void visit_pool(
+      size_t const class_index, FCallback &&callback,
+      std::index_sequence<IClass...>) {
+    ((class_index == IClass ? (callback(std::get<IClass>(pools_)), true)
+                            : false) or
+     ...);
+  }
+
+  template <typename FCallback>
+  void visit_pool(size_t const class_index, FCallback &&callback) {
+    visit_pool(
+        class_index, std::forward<FCallback>(callback),
+        std::make_index_sequence<class_count>{});
+  }
+
+public:
+  std::pmr::memory_resource *upstream_resource() const { return upstream_; }
+
+  size_t count_chunks() const {
+    return std::apply(
+        [](auto const &...pools) { return (pools.count_chunks() + ...); },
+        pools_);
+  }
+
+public:
+  // Frees all chunks without allocations, e.g. after a load spike.
+  size_t trim() {
+    return std::apply(
+        [](auto &...pools) { return (pools.trim() + ...); }, pools_);
+  }
+
+  void release() {
+    std::apply([](auto &...pools) { (pools.clear(), ...); }, pools_);
+
+    for (auto const &[pointer, layout] : large_allocations_)
+      upstream_->deallocate(pointer, layout.first, layout.second);
+    large_allocations_.clear();
+  }
+
+protected:
+  void *do_allocate(size_t const bytes, size_t const alignment) override {
+    if (not is_slab_allocation(bytes, alignment)) {
+      auto *pointer = upstream_->allocate(bytes, alignment);
+      large_allocations_.emplace(pointer, std::make_pair(bytes, alignment));
+      return pointer;
+    }
+
+    void *pointer = nullptr;
+    visit_pool(get_class_index(bytes), [&pointer](auto &pool) {
+      pointer = pool.acquire();
+    });
+    return pointer;
+  }
+
+  void do_deallocate(
+      void *const pointer, size_t const bytes,
+      size_t const alignment) override {
+    if (not is_slab_allocation(bytes, alignment)) {
+      upstream_->deallocate(pointer, bytes, alignment);
+      large_allocations_.erase(pointer);
+      return;
+    }
+
+    visit_pool(get_class_index(bytes), [pointer](auto &pool) {
+      using block_type = typename std::remove_reference_t<
+          decltype(pool)>::object_type;
+      pool.release(static_cast<block_type *>(pointer));
+    });
+  }
+
+  bool do_is_equal(
+      std::pmr::memory_resource const &other) const noexcept override {
+    return this == &other;
+  }
+
+public:
+  slab_memory_resource()
+      : slab_memory_resource(std::pmr::get_default_resource()) {}
+
+  explicit slab_memory_resource(std::pmr::memory_resource *upstream)
+      : upstream_{upstream} {}
+
+  slab_memory_resource(slab_memory_resource const &) = delete;
+  slab_memory_resource &operator=(slab_memory_resource const &) = delete;
+
+  ~slab_memory_resource() override { release(); }
+
+private:
+  std::pmr::memory_resource *upstream_;
+  pools_type pools_;
+  hash_map<void *, std::pair<size_t, size_t>> large_allocations_;
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_SLAB_MEMORY_RESOURCE_HPP_5C1E9E272D7746B39441D6927A3745D0
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+
+#include "slab_memory_resource.hpp"
+
+#include <cstring>
+#include <vector>
+
+using namespace ungrd;
+
+TEST(SlabMemoryResource, Correctness) {
+  slab_memory_resource resource;
+
+  std::vector<std::pair<void *, size_t>> allocations;
+  for (size_t bytes : {1, 16, 17, 100, 2048, 2049, 100000}) {
+    for (size_t count = 0; count < 10; ++count) {
+      auto *pointer = resource.allocate(bytes);
+      ASSERT_EQ(
+          0, reinterpret_cast<std::uintptr_t>(pointer) %
+                 alignof(std::max_align_t));
+      std::memset(pointer, static_cast<int>(count), bytes);
+      allocations.emplace_back(pointer, bytes);
+    }
+  }
+  ASSERT_LT(0, resource.count_chunks());
+
+  for (size_t index = 0; index < allocations.size(); index += 2) {
+    auto const [pointer, bytes] = allocations[index];
+    resource.deallocate(pointer, bytes);
+  }
+
+  {
+    std::pmr::vector<int> values{&resource};
+    for (int value = 0; value < 1000; ++value)
+      values.emplace_back(value);
+    for (int value = 0; value < 1000; ++value)
+      ASSERT_EQ(value, values[value]);
+  }
+
+  resource.release();
+  ASSERT_EQ(0, resource.count_chunks());
+}
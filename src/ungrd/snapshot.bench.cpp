@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "grid.bench.hpp"
+#include "snapshot.hpp"
+
+#include "cxx/mapped_file.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace ungrd;
+
+namespace {
+
+template <typename Grid>
+std::string write_snapshot_file(benchmark::State &state) {
+  auto const &input = Grid_RandomCells_Input<Grid>(state);
+
+  Grid grid;
+  grid.update(input);
+
+  auto const path = std::filesystem::temp_directory_path() /
+                    "ungrd-snapshot-bench.bin";
+  std::ofstream out{path, std::ios::binary};
+  write_snapshot(grid, out);
+  return path.string();
+}
+
+} // namespace
+
+// Rebuilds a grid from the input, which is what loading a grid takes without
+// snapshots.
+template <typename Grid>
+void BMT_Snapshot_Rebuild(benchmark::State &state) {
+  auto const &input = Grid_RandomCells_Input<Grid>(state);
+  state.counters["ne"] = input.size();
+
+  for (auto _ : state) {
+    Grid grid;
+    grid.update(input);
+    benchmark::DoNotOptimize(grid.count_filled_cells());
+  }
+}
+BENCHMARK_TEMPLATE(BMT_Snapshot_Rebuild, s32_e32_dense_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BMT_Snapshot_Rebuild, s32_e32_compact_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE})
+    ->Unit(benchmark::kMillisecond);
+
+// Maps a snapshot file and queries one cell.
+template <typename Grid>
+void BMT_Snapshot_Load(benchmark::State &state) {
+  auto const path = write_snapshot_file<Grid>(state);
+
+  using view_type =
+      snapshot_view<typename Grid::space_policy, typename Grid::entry_policy>;
+
+  for (auto _ : state) {
+    mapped_file const file{path};
+    view_type const view{file.bytes()};
+
+    size_t count = 0;
+    view.foreach_entry_at_position({0, 0, 0}, [&count](auto) { ++count; });
+    benchmark::DoNotOptimize(count);
+  }
+
+  std::filesystem::remove(path);
+}
+BENCHMARK_TEMPLATE(BMT_Snapshot_Load, s32_e32_dense_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE})
+    ->Unit(benchmark::kMillisecond);
+
+// Maps a snapshot file and sums all of its entries, which touches every page
+// of the file.
+template <typename Grid>
+void BMT_Snapshot_LoadAndSumAllEntries(benchmark::State &state) {
+  auto const path = write_snapshot_file<Grid>(state);
+
+  using view_type =
+      snapshot_view<typename Grid::space_policy, typename Grid::entry_policy>;
+
+  for (auto _ : state) {
+    mapped_file const file{path};
+    view_type const view{file.bytes()};
+
+    auto const [lo, hi] = view.bounding_box();
+    size_t sum = 0;
+    view.foreach_entry_in_box(
+        lo, hi, [&sum](auto const entry) { sum += entry; });
+    benchmark::DoNotOptimize(sum);
+  }
+
+  std::filesystem::remove(path);
+}
+BENCHMARK_TEMPLATE(BMT_Snapshot_LoadAndSumAllEntries, s32_e32_dense_grid<3>)
+    ->Ranges({EXTENT_RANGE, EXTENT_RANGE, EXTENT_RANGE, RANDOM_ENTRY_RANGE})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,409 @@
+#ifndef UNGRD_SNAPSHOT_HPP_57A355F9034B432197D374AE4FAC80AD
+#define UNGRD_SNAPSHOT_HPP_57A355F9034B432197D374AE4FAC80AD
+
+#include "entry_cell.hpp"
+
+#include <algorithm>
+#include <array>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ungrd {
+
+// A snapshot is a flat, relocatable image of the filled cells of a grid that
+// can be queried in place, e.g. in a memory mapped file. All offsets are
+// relative to the start of the snapshot, every section starts at a multiple of
+// snapshot_alignment bytes:
+//
+//   snapshot_header
+//   bounds         2 x ndim position indices, the inclusive bounding box
+//   positions      cell_count x ndim position indices, lexicographically sorted
+//   entry_offsets  cell_count + 1 uint64, the entries of the cell i are
+//                  entries[entry_offsets[i], entry_offsets[i + 1])
+//   entries        entry_count entries
+//
+// Values are stored in the byte order of the machine that wrote them.
+struct snapshot_header {
+  static constexpr std::array<char, 8> expected_magic = {
+      'U', 'N', 'G', 'R', 'D', 'S', 'N', 'P'};
+  static constexpr std::uint32_t current_version = 1;
+  static constexpr std::uint32_t expected_byte_order = 0x01020304;
+
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t ndim;
+  std::uint32_t position_index_size;
+  std::uint32_t entry_size;
+  std::uint32_t reserved;
+  std::uint64_t cell_count;
+  std::uint64_t entry_count;
+  std::uint64_t bounds_offset;
+  std::uint64_t positions_offset;
+  std::uint64_t entry_offsets_offset;
+  std::uint64_t entries_offset;
+  std::uint64_t size;
+};
+
+static_assert(std::is_trivially_copyable_v<snapshot_header>);
+
+inline constexpr std::size_t snapshot_alignment = 64;
+
+// Writes a snapshot of the filled cells of grid to out. Throws
+// std::runtime_error if writing fails.
+template <typename TGrid>
+void write_snapshot(TGrid const &grid, std::ostream &out) {
+  using space_policy = typename TGrid::space_policy;
+  using entry_policy = typename TGrid::entry_policy;
+  using position_type = typename space_policy::position;
+  using position_index_type = typename position_type::value_type;
+  using entry_type = typename entry_policy::entry;
+
+  constexpr std::size_t ndim = space_policy::ndim;
+
+  static_assert(
+      std::is_void_v<typename entry_policy::payload>,
+      "snapshots do not store payloads");
+
+  std::vector<position_type> cposes;
+  grid.foreach_position(
+      [&cposes](position_type const &cpos) { cposes.push_back(cpos); });
+  std::sort(cposes.begin(), cposes.end());
+
+  std::vector<std::uint64_t> entry_offsets;
+  std::vector<entry_type> entries;
+  entry_offsets.reserve(cposes.size() + 1);
+  entry_offsets.push_back(0);
+  for (auto const &cpos : cposes) {
+    grid.foreach_entry_at_position(
+        cpos, [&entries](entry_type const entry) { entries.push_back(entry); });
+    entry_offsets.push_back(entries.size());
+  }
+
+  std::array<position_type, 2> bounds = {
+      space_policy::most_positive_position(),
+      space_policy::most_negative_position()};
+  for (auto const &cpos : cposes) {
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      bounds[0][dim] = std::min(bounds[0][dim], cpos[dim]);
+      bounds[1][dim] = std::max(bounds[1][dim], cpos[dim]);
+    }
+  }
+
+  auto const align = [](std::uint64_t const offset) {
+    return (offset + snapshot_alignment - 1) / snapshot_alignment *
+           snapshot_alignment;
+  };
+
+  snapshot_header header;
+  header.magic = snapshot_header::expected_magic;
+  header.version = snapshot_header::current_version;
+  header.byte_order = snapshot_header::expected_byte_order;
+  header.ndim = ndim;
+  header.position_index_size = sizeof(position_index_type);
+  header.entry_size = sizeof(entry_type);
+  header.reserved = 0;
+  header.cell_count = cposes.size();
+  header.entry_count = entries.size();
+  header.bounds_offset = align(sizeof(snapshot_header));
+  header.positions_offset =
+      align(header.bounds_offset + 2 * ndim * sizeof(position_index_type));
+  header.entry_offsets_offset = align(
+      header.positions_offset +
+      cposes.size() * ndim * sizeof(position_index_type));
+  header.entries_offset = align(
+      header.entry_offsets_offset +
+      entry_offsets.size() * sizeof(std::uint64_t));
+  header.size = header.entries_offset + entries.size() * sizeof(entry_type);
+
+  std::uint64_t written = 0;
+  auto const write_at = [&out, &written](
+                            std::uint64_t const offset, void const *data,
+                            std::size_t const bytes) {
+    static constexpr std::array<char, snapshot_alignment> padding = {};
+    out.write(padding.data(), offset - written);
+    out.write(static_cast<char const *>(data), bytes);
+    written = offset + bytes;
+  };
+
+  write_at(0, &header, sizeof(header));
+
+  std::vector<position_index_type> indices;
+  for (auto const &cpos : bounds)
+    indices.insert(indices.end(), cpos.begin(), cpos.end());
+  write_at(
+      header.bounds_offset, indices.data(),
+      indices.size() * sizeof(position_index_type));
+
+  indices.clear();
+  for (auto const &cpos : cposes)
+    indices.insert(indices.end(), cpos.begin(), cpos.end());
+  write_at(
+      header.positions_offset, indices.data(),
+      indices.size() * sizeof(position_index_type));
+
+  write_at(
+      header.entry_offsets_offset, entry_offsets.data(),
+      entry_offsets.size() * sizeof(std::uint64_t));
+  write_at(
+      header.entries_offset, entries.data(),
+      entries.size() * sizeof(entry_type));
+
+  if (not out)
+    throw std::runtime_error{"ungrd: writing the snapshot failed"};
+}
+
+// Queries a snapshot in place, without copying or deserializing it. The bytes
+// must stay valid for the lifetime of the view. Positions are found by binary
+// search over the sorted cell positions. Throws std::runtime_error if the
+// bytes are not a snapshot of a grid with the given policies. Only the header
+// is validated, the entry offsets are trusted to be ascending.
+template <typename PSpace, typename PEntry>
+class snapshot_view {
+public:
+  using space_policy = PSpace;
+  using entry_policy = PEntry;
+
+private:
+  static constexpr std::size_t ndim = space_policy::ndim;
+  using position_type = typename space_policy::position;
+  using position_index_type = typename position_type::value_type;
+  using entry_type = typename entry_policy::entry;
+
+  using view_type = entry_cell_view<entry_policy>;
+
+  static_assert(std::is_void_v<typename entry_policy::payload>);
+
+public:
+  size_t count_filled_cells() const { return cell_count_; }
+
+  size_t count_entries() const { return entry_count_; }
+
+  std::pair<position_type, position_type> bounding_box() const {
+    return {bounds_lo_, bounds_hi_};
+  }
+
+public:
+  template <typename FCallback>
+  void foreach_entry_at_position(
+      position_type const &cpos, FCallback callback) const {
+    auto const cell = lower_bound(cpos);
+    if (cell < cell_count_ and cell_position(cell) == cpos)
+      for (auto const entry : cell_entries(cell))
+        callback(entry);
+  }
+
+  // Calls callback(entry) for every entry in the cells of the box [lo, hi].
+  template <typename FCallback>
+  void foreach_entry_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    foreach_cell_in_box(lo, hi, [&callback](view_type const &view) {
+      for (auto const entry : view.entries)
+        callback(entry);
+    });
+  }
+
+  // Calls callback(view) for every filled cell in the box [lo, hi]. Every row
+  // of the box along the last dimension is found with a binary search, boxes
+  // with more rows than cells scan all cells instead.
+  template <typename FCallback>
+  void foreach_cell_in_box(
+      position_type const &lo, position_type const &hi,
+      FCallback callback) const {
+    constexpr size_t last_dim = ndim - 1;
+
+    // the row count is only compared to the cell count, saturate above it
+    size_t row_count = 1;
+    for (size_t dim = 0; dim < ndim; ++dim) {
+      if (lo[dim] > hi[dim])
+        return;
+      if (dim == last_dim)
+        continue;
+
+      auto const span =
+          static_cast<size_t>(hi[dim]) - static_cast<size_t>(lo[dim]);
+      if (row_count > cell_count_ or span >= cell_count_)
+        row_count = cell_count_ + 1;
+      else
+        row_count *= span + 1;
+    }
+
+    if (row_count <= cell_count_) {
+      position_type row = lo;
+      while (true) {
+        for (auto cell = lower_bound(row); cell < cell_count_; ++cell) {
+          auto const *const cpos = positions_ + cell * ndim;
+          if (not std::equal(cpos, cpos + last_dim, row.begin()) or
+              cpos[last_dim] > hi[last_dim])
+            break;
+          callback(cell_view(cell));
+        }
+
+        size_t dim = last_dim;
+        while (true) {
+          if (dim == 0)
+            return;
+          --dim;
+
+          if (row[dim] < hi[dim]) {
+            ++row[dim];
+            break;
+          }
+          row[dim] = lo[dim];
+        }
+      }
+    } else {
+      for (size_t cell = 0; cell < cell_count_; ++cell) {
+        auto const *const cpos = positions_ + cell * ndim;
+
+        bool inside = true;
+        for (size_t dim = 0; dim < ndim; ++dim)
+          inside &= lo[dim] <= cpos[dim] and cpos[dim] <= hi[dim];
+
+        if (inside)
+          callback(cell_view(cell));
+      }
+    }
+  }
+
+  template <typename FCallback>
+  void foreach_position(FCallback callback) const {
+    for (size_t cell = 0; cell < cell_count_; ++cell) {
+      auto const cpos = cell_position(cell);
+      callback(cpos);
+    }
+  }
+
+private:
+  position_type cell_position(size_t const cell) const {
+    position_type cpos;
+    std::copy_n(positions_ + cell * ndim, ndim, cpos.begin());
+    return cpos;
+  }
+
+  std::span<entry_type const> cell_entries(size_t const cell) const {
+    return {
+        entries_ + entry_offsets_[cell],
+        entries_ + entry_offsets_[cell + 1]};
+  }
+
+  view_type cell_view(size_t const cell) const {
+    view_type view;
+    view.entries = cell_entries(cell);
+    return view;
+  }
+
+  // the first cell whose position is not less than cpos
+  size_t lower_bound(position_type const &cpos) const {
+    size_t first = 0, count = cell_count_;
+    while (count > 0) {
+      auto const half = count / 2;
+      auto const *const other = positions_ + (first + half) * ndim;
+      if (std::lexicographical_compare(
+              other, other + ndim, cpos.begin(), cpos.end())) {
+        first += half + 1;
+        count -= half + 1;
+      } else {
+        count = half;
+      }
+    }
+    return first;
+  }
+
+public:
+  explicit snapshot_view(std::span<std::byte const> const bytes) {
+    auto const fail = [](char const *what) {
+      throw std::runtime_error{std::string{"ungrd: invalid snapshot, "} + what};
+    };
+
+    if (bytes.size() < sizeof(snapshot_header))
+      fail("too small");
+    if (reinterpret_cast<std::uintptr_t>(bytes.data()) %
+            alignof(std::uint64_t) !=
+        0)
+      fail("misaligned");
+
+    snapshot_header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if (header.magic != snapshot_header::expected_magic)
+      fail("wrong magic");
+    if (header.version != snapshot_header::current_version)
+      fail("unsupported version");
+    if (header.byte_order != snapshot_header::expected_byte_order)
+      fail("wrong byte order");
+    if (header.ndim != ndim or
+        header.position_index_size != sizeof(position_index_type) or
+        header.entry_size != sizeof(entry_type))
+      fail("wrong policies");
+
+    // whether count records of size bytes fit behind offset, the counts come
+    // from the file and are never multiplied or incremented
+    auto const section_fits = [&header](
+                                  std::uint64_t const offset,
+                                  std::uint64_t const count,
+                                  std::uint64_t const size) {
+      return offset % snapshot_alignment == 0 and offset <= header.size and
+             count <= (header.size - offset) / size;
+    };
+    if (header.size > bytes.size() or
+        not section_fits(
+            header.bounds_offset, 2, ndim * sizeof(position_index_type)) or
+        not section_fits(
+            header.positions_offset, header.cell_count,
+            ndim * sizeof(position_index_type)) or
+        not section_fits(
+            header.entry_offsets_offset, header.cell_count,
+            sizeof(std::uint64_t)) or
+        // the entry offsets hold one more value than there are cells
+        (header.size - header.entry_offsets_offset) /
+                sizeof(std::uint64_t) ==
+            header.cell_count or
+        not section_fits(
+            header.entries_offset, header.entry_count, sizeof(entry_type)))
+      fail("truncated");
+
+    auto const *const base = bytes.data();
+    auto const *const bounds = reinterpret_cast<position_index_type const *>(
+        base + header.bounds_offset);
+    std::copy_n(bounds, ndim, bounds_lo_.begin());
+    std::copy_n(bounds + ndim, ndim, bounds_hi_.begin());
+
+    positions_ = reinterpret_cast<position_index_type const *>(
+        base + header.positions_offset);
+    entry_offsets_ = reinterpret_cast<std::uint64_t const *>(
+        base + header.entry_offsets_offset);
+    entries_ =
+        reinterpret_cast<entry_type const *>(base + header.entries_offset);
+    cell_count_ = header.cell_count;
+    entry_count_ = header.entry_count;
+
+    if (entry_offsets_[0] != 0 or entry_offsets_[cell_count_] != entry_count_)
+      fail("inconsistent entry offsets");
+  }
+
+private:
+  position_index_type const *positions_ = nullptr;
+  std::uint64_t const *entry_offsets_ = nullptr;
+  entry_type const *entries_ = nullptr;
+
+  size_t cell_count_ = 0;
+  size_t entry_count_ = 0;
+
+  position_type bounds_lo_ = {};
+  position_type bounds_hi_ = {};
+};
+
+} // namespace ungrd
+
+#endif // UNGRD_SNAPSHOT_HPP_57A355F9034B432197D374AE4FAC80AD
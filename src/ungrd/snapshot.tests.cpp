@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+
+#include "compact_grid.hpp"
+#include "dense_grid.hpp"
+#include "snapshot.hpp"
+
+#include "cxx/mapped_file.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <span>
+#include <sstream>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+using namespace ungrd;
+
+namespace {
+
+std::vector<std::byte> to_bytes(std::string const &string) {
+  std::vector<std::byte> bytes(string.size());
+  std::memcpy(bytes.data(), string.data(), string.size());
+  return bytes;
+}
+
+// Writes a snapshot of a grid and compares queries on the snapshot with
+// queries on the grid.
+template <typename Grid>
+void T_Snapshot_Queries() {
+  using position_type = typename Grid::space_policy::position;
+  using entry_type = typename Grid::entry_policy::entry;
+  using view_type =
+      snapshot_view<typename Grid::space_policy, typename Grid::entry_policy>;
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> coordinate_dis{-6, 6};
+  std::uniform_int_distribution<int> box_dis{-9, 9};
+
+  std::vector<std::pair<position_type, entry_type>> input;
+  for (entry_type entry = 0; entry < 300; ++entry) {
+    position_type cpos;
+    for (auto &index : cpos)
+      index = coordinate_dis(gen);
+    input.emplace_back(cpos, entry);
+  }
+
+  Grid grid;
+  grid.update(input);
+
+  std::ostringstream out;
+  write_snapshot(grid, out);
+  auto const bytes = to_bytes(out.str());
+
+  view_type const view{bytes};
+  ASSERT_EQ(grid.count_filled_cells(), view.count_filled_cells());
+  ASSERT_EQ(input.size(), view.count_entries());
+
+  auto const sorted_entries = [](auto const &source, auto const &lo,
+                                 auto const &hi) {
+    std::vector<entry_type> entries;
+    source.foreach_entry_in_box(
+        lo, hi, [&entries](auto const entry) { entries.push_back(entry); });
+    std::sort(entries.begin(), entries.end());
+    return entries;
+  };
+
+  std::vector<position_type> positions;
+  view.foreach_position([&](auto const &cpos) {
+    positions.push_back(cpos);
+
+    std::vector<entry_type> expected, entries;
+    grid.foreach_entry_at_position(
+        cpos, [&expected](auto const entry) { expected.push_back(entry); });
+    view.foreach_entry_at_position(
+        cpos, [&entries](auto const entry) { entries.push_back(entry); });
+    ASSERT_EQ(expected, entries);
+  });
+  ASSERT_TRUE(std::is_sorted(positions.begin(), positions.end()));
+
+  auto const [lo, hi] = view.bounding_box();
+  ASSERT_EQ(input.size(), sorted_entries(view, lo, hi).size());
+
+  for (size_t round = 0; round < 200; ++round) {
+    position_type lo, hi;
+    for (size_t dim = 0; dim < lo.size(); ++dim) {
+      lo[dim] = box_dis(gen);
+      hi[dim] = box_dis(gen);
+      if (round % 8 != 0 and lo[dim] > hi[dim])
+        std::swap(lo[dim], hi[dim]);
+    }
+    ASSERT_EQ(sorted_entries(grid, lo, hi), sorted_entries(view, lo, hi));
+  }
+}
+
+} // namespace
+
+TEST(Snapshot, DenseGridQueries) {
+  T_Snapshot_Queries<s32_e32_dense_grid<3>>();
+}
+
+TEST(Snapshot, CompactGridQueries) {
+  T_Snapshot_Queries<s32_e32_compact_grid<3>>();
+}
+
+TEST(Snapshot, OneDimensionalQueries) {
+  T_Snapshot_Queries<s32_e32_dense_grid<1>>();
+}
+
+TEST(Snapshot, Empty) {
+  s32_e32_compact_grid<2> grid;
+
+  std::ostringstream out;
+  write_snapshot(grid, out);
+  auto const bytes = to_bytes(out.str());
+
+  snapshot_view<s32_space_policy<2>, u32_entry_policy> const view{bytes};
+  ASSERT_EQ(0, view.count_filled_cells());
+
+  size_t count = 0;
+  view.foreach_entry_in_box(
+      {-100, -100}, {100, 100}, [&count](auto const) { ++count; });
+  ASSERT_EQ(0, count);
+}
+
+TEST(Snapshot, Invalid) {
+  using view_type = snapshot_view<s32_space_policy<3>, u32_entry_policy>;
+
+  s32_e32_dense_grid<3> grid;
+  std::vector<std::pair<std::array<int, 3>, std::uint32_t>> input = {
+      {{1, 2, 3}, 4}, {{-1, 0, 5}, 6}};
+  grid.update(input);
+
+  std::ostringstream out;
+  write_snapshot(grid, out);
+  auto bytes = to_bytes(out.str());
+
+  ASSERT_NO_THROW(view_type{bytes});
+
+  // wrong policies
+  ASSERT_THROW(
+      (snapshot_view<s32_space_policy<2>, u32_entry_policy>{bytes}),
+      std::runtime_error);
+  ASSERT_THROW(
+      (snapshot_view<s32_space_policy<3>, u64_entry_policy>{bytes}),
+      std::runtime_error);
+
+  // truncated
+  ASSERT_THROW(
+      view_type{std::span{bytes}.first(bytes.size() - 1)}, std::runtime_error);
+  ASSERT_THROW(view_type{std::span{bytes}.first(16)}, std::runtime_error);
+
+  // cell counts for which the section sizes overflow
+  for (std::uint64_t const cell_count :
+       {std::numeric_limits<std::uint64_t>::max(),
+        std::uint64_t{0x5555'5555'5555'5556}}) {
+    auto corrupted = bytes;
+    std::memcpy(
+        corrupted.data() + offsetof(snapshot_header, cell_count), &cell_count,
+        sizeof(cell_count));
+    ASSERT_THROW(view_type{corrupted}, std::runtime_error);
+  }
+
+  // wrong magic
+  bytes[0] = std::byte{'X'};
+  ASSERT_THROW(view_type{bytes}, std::runtime_error);
+}
+
+TEST(Snapshot, MappedFile) {
+  s32_e32_dense_grid<3> grid;
+  std::vector<std::pair<std::array<int, 3>, std::uint32_t>> input = {
+      {{1, 2, 3}, 4}, {{1, 2, 3}, 5}, {{-1, 0, 5}, 6}};
+  grid.update(input);
+
+  auto const path = std::filesystem::temp_directory_path() /
+                    "ungrd-snapshot-tests-mapped-file.bin";
+  {
+    std::ofstream out{path, std::ios::binary};
+    write_snapshot(grid, out);
+  }
+
+  {
+    mapped_file const file{path.string()};
+    snapshot_view<s32_space_policy<3>, u32_entry_policy> const view{
+        file.bytes()};
+
+    std::vector<std::uint32_t> entries;
+    view.foreach_entry_at_position(
+        {1, 2, 3}, [&entries](auto const entry) { entries.push_back(entry); });
+    ASSERT_EQ((std::vector<std::uint32_t>{4, 5}), entries);
+  }
+
+  std::filesystem::remove(path);
+
+  ASSERT_THROW(mapped_file{path.string()}, std::system_error);
+}
@@ -1,6 +1,8 @@
 #ifndef UNGRD_SPACE_POLICY_HPP_C156B753F8AE4F3880370E3FC531A979
 #define UNGRD_SPACE_POLICY_HPP_C156B753F8AE4F3880370E3FC531A979
 
+#include "cxx/modulo.hpp"
+
 #include <array>
 #include <limits>
 
@@ -12,9 +14,20 @@ namespace ungrd {
 template <typename TIndex, std::size_t NDim>
 struct space_policy {
   static constexpr std::size_t ndim = NDim;
+  static constexpr bool periodic = false;
 
   using position = std::array<TIndex, NDim>;
 
+  static constexpr position wrap(position const &cpos) { return cpos; }
+
+  // Calls callback(lo, hi) with the boxes that cover the box [lo, hi] once
+  // positions are wrapped, which is just the box itself.
+  template <typename FCallback>
+  static constexpr void foreach_wrapped_box(
+      position const &lo, position const &hi, FCallback callback) {
+    callback(lo, hi);
+  }
+
   static constexpr position most_positive_position() {
     position result;
     result.fill(std::numeric_limits<TIndex>::max());
@@ -28,12 +41,116 @@ struct space_policy {
   }
 };
 
+template <std::size_t NDim>
+using s16_space_policy = space_policy<std::int16_t, NDim>;
+
 template <std::size_t NDim>
 using s32_space_policy = space_policy<std::int32_t, NDim>;
 
 template <std::size_t NDim>
 using s64_space_policy = space_policy<std::int64_t, NDim>;
 
+// A periodic box of cells, cell positions wrap modulo the extents into
+// [0, extent) in every dimension. Grids store and report wrapped positions,
+// box queries may extend past the faces of the box.
+template <typename TIndex, std::size_t... NExtents>
+struct periodic_space_policy {
+  static constexpr std::size_t ndim = sizeof...(NExtents);
+  static constexpr bool periodic = true;
+
+  using position = std::array<TIndex, ndim>;
+
+  static_assert(((NExtents > 0) and ...));
+  static_assert(
+      ((NExtents <= std::size_t(std::numeric_limits<TIndex>::max())) and ...));
+
+  static constexpr position extents() {
+    return {static_cast<TIndex>(NExtents)...};
+  }
+
+  static constexpr position most_positive_position() {
+    position result = extents();
+    for (auto &index : result)
+      --index;
+    return result;
+  }
+
+  static constexpr position most_negative_position() { return {}; }
+
+  static constexpr position wrap(position const &cpos) {
+    position result;
+    for (std::size_t dim = 0; dim < ndim; ++dim)
+      result[dim] = static_cast<TIndex>(
+          modulo(std::int64_t{cpos[dim]}, std::int64_t{extents()[dim]}));
+    return result;
+  }
+
+  // Calls callback(lo, hi) with up to 2^ndim disjoint boxes of wrapped
+  // positions that cover the box [lo, hi] once positions are wrapped. Boxes
+  // that are at least as large as the domain are clipped to it, so that every
+  // cell is covered once.
+  template <typename FCallback>
+  static constexpr void foreach_wrapped_box(
+      position const &lo, position const &hi, FCallback callback) {
+    // per dimension one or two intervals of wrapped positions
+    std::array<std::array<TIndex, 2>, ndim> firsts, lasts;
+    std::array<std::size_t, ndim> counts;
+
+    for (std::size_t dim = 0; dim < ndim; ++dim) {
+      if (lo[dim] > hi[dim])
+        return;
+
+      std::int64_t const extent = extents()[dim];
+      std::int64_t const span = std::int64_t{hi[dim]} - lo[dim];
+      std::int64_t const first = modulo(std::int64_t{lo[dim]}, extent);
+      std::int64_t const last = first + span;
+
+      if (span + 1 >= extent) {
+        firsts[dim][0] = 0;
+        lasts[dim][0] = static_cast<TIndex>(extent - 1);
+        counts[dim] = 1;
+      } else if (last < extent) {
+        firsts[dim][0] = static_cast<TIndex>(first);
+        lasts[dim][0] = static_cast<TIndex>(last);
+        counts[dim] = 1;
+      } else {
+        firsts[dim] = {static_cast<TIndex>(first), 0};
+        lasts[dim] = {
+            static_cast<TIndex>(extent - 1),
+            static_cast<TIndex>(last - extent)};
+        counts[dim] = 2;
+      }
+    }
+
+    std::array<std::size_t, ndim> choices = {};
+    while (true) {
+      position box_lo, box_hi;
+      for (std::size_t dim = 0; dim < ndim; ++dim) {
+        box_lo[dim] = firsts[dim][choices[dim]];
+        box_hi[dim] = lasts[dim][choices[dim]];
+      }
+      callback(
+          static_cast<position const &>(box_lo),
+          static_cast<position const &>(box_hi));
+
+      std::size_t dim = ndim;
+      while (true) {
+        if (dim == 0)
+          return;
+        --dim;
+
+        if (++choices[dim] < counts[dim])
+          break;
+        choices[dim] = 0;
+      }
+    }
+  }
+};
+
+template <std::size_t... NExtents>
+using s32_periodic_space_policy =
+    periodic_space_policy<std::int32_t, NExtents...>;
+
 } // namespace ungrd
 
 #endif // UNGRD_SPACE_POLICY_HPP_C156B753F8AE4F3880370E3FC531A979